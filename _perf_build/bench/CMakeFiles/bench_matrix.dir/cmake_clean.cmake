@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_matrix.dir/bench_matrix.cpp.o"
+  "CMakeFiles/bench_matrix.dir/bench_matrix.cpp.o.d"
+  "bench_matrix"
+  "bench_matrix.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_matrix.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/update_perf_baseline"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/update_perf_baseline.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
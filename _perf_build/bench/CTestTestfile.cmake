@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/bench
+# Build directory: /root/repo/_perf_build/bench
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(perf_matrix "/root/repo/_perf_build/bench/bench_matrix" "--compare" "/root/repo/bench/perf_baseline.json")
+set_tests_properties(perf_matrix PROPERTIES  LABELS "perf" RUN_SERIAL "TRUE" _BACKTRACE_TRIPLES "/root/repo/bench/CMakeLists.txt;23;add_test;/root/repo/bench/CMakeLists.txt;0;")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest.dir/gtest-all.cc.o"
+  "CMakeFiles/gtest.dir/gtest-all.cc.o.d"
+  "libgtest.a"
+  "libgtest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,33 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/test/test_main.cpp" "test/CMakeFiles/test_matrix.dir/test_main.cpp.o" "gcc" "test/CMakeFiles/test_matrix.dir/test_main.cpp.o.d"
+  "/root/repo/test/test_tblas.cpp" "test/CMakeFiles/test_matrix.dir/test_tblas.cpp.o" "gcc" "test/CMakeFiles/test_matrix.dir/test_tblas.cpp.o.d"
+  "/root/repo/test/test_tgemm.cpp" "test/CMakeFiles/test_matrix.dir/test_tgemm.cpp.o" "gcc" "test/CMakeFiles/test_matrix.dir/test_tgemm.cpp.o.d"
+  "/root/repo/test/test_tkernels.cpp" "test/CMakeFiles/test_matrix.dir/test_tkernels.cpp.o" "gcc" "test/CMakeFiles/test_matrix.dir/test_tkernels.cpp.o.d"
+  "/root/repo/test/test_tlinalg.cpp" "test/CMakeFiles/test_matrix.dir/test_tlinalg.cpp.o" "gcc" "test/CMakeFiles/test_matrix.dir/test_tlinalg.cpp.o.d"
+  "/root/repo/test/test_tmatrix.cpp" "test/CMakeFiles/test_matrix.dir/test_tmatrix.cpp.o" "gcc" "test/CMakeFiles/test_matrix.dir/test_tmatrix.cpp.o.d"
+  "/root/repo/test/test_tmatrix_io.cpp" "test/CMakeFiles/test_matrix.dir/test_tmatrix_io.cpp.o" "gcc" "test/CMakeFiles/test_matrix.dir/test_tmatrix_io.cpp.o.d"
+  "/root/repo/test/test_toperator.cpp" "test/CMakeFiles/test_matrix.dir/test_toperator.cpp.o" "gcc" "test/CMakeFiles/test_matrix.dir/test_toperator.cpp.o.d"
+  "/root/repo/test/test_tpermutation.cpp" "test/CMakeFiles/test_matrix.dir/test_tpermutation.cpp.o" "gcc" "test/CMakeFiles/test_matrix.dir/test_tpermutation.cpp.o.d"
+  "/root/repo/test/test_tprofile.cpp" "test/CMakeFiles/test_matrix.dir/test_tprofile.cpp.o" "gcc" "test/CMakeFiles/test_matrix.dir/test_tprofile.cpp.o.d"
+  "/root/repo/test/test_tsolvers.cpp" "test/CMakeFiles/test_matrix.dir/test_tsolvers.cpp.o" "gcc" "test/CMakeFiles/test_matrix.dir/test_tsolvers.cpp.o.d"
+  "/root/repo/test/test_tsparse.cpp" "test/CMakeFiles/test_matrix.dir/test_tsparse.cpp.o" "gcc" "test/CMakeFiles/test_matrix.dir/test_tsparse.cpp.o.d"
+  "/root/repo/test/test_tstrassen.cpp" "test/CMakeFiles/test_matrix.dir/test_tstrassen.cpp.o" "gcc" "test/CMakeFiles/test_matrix.dir/test_tstrassen.cpp.o.d"
+  "/root/repo/test/test_tvector.cpp" "test/CMakeFiles/test_matrix.dir/test_tvector.cpp.o" "gcc" "test/CMakeFiles/test_matrix.dir/test_tvector.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_perf_build/gtest/CMakeFiles/gtest.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,37 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_matrix.dir/test_main.cpp.o"
+  "CMakeFiles/test_matrix.dir/test_main.cpp.o.d"
+  "CMakeFiles/test_matrix.dir/test_tblas.cpp.o"
+  "CMakeFiles/test_matrix.dir/test_tblas.cpp.o.d"
+  "CMakeFiles/test_matrix.dir/test_tgemm.cpp.o"
+  "CMakeFiles/test_matrix.dir/test_tgemm.cpp.o.d"
+  "CMakeFiles/test_matrix.dir/test_tkernels.cpp.o"
+  "CMakeFiles/test_matrix.dir/test_tkernels.cpp.o.d"
+  "CMakeFiles/test_matrix.dir/test_tlinalg.cpp.o"
+  "CMakeFiles/test_matrix.dir/test_tlinalg.cpp.o.d"
+  "CMakeFiles/test_matrix.dir/test_tmatrix.cpp.o"
+  "CMakeFiles/test_matrix.dir/test_tmatrix.cpp.o.d"
+  "CMakeFiles/test_matrix.dir/test_tmatrix_io.cpp.o"
+  "CMakeFiles/test_matrix.dir/test_tmatrix_io.cpp.o.d"
+  "CMakeFiles/test_matrix.dir/test_toperator.cpp.o"
+  "CMakeFiles/test_matrix.dir/test_toperator.cpp.o.d"
+  "CMakeFiles/test_matrix.dir/test_tpermutation.cpp.o"
+  "CMakeFiles/test_matrix.dir/test_tpermutation.cpp.o.d"
+  "CMakeFiles/test_matrix.dir/test_tprofile.cpp.o"
+  "CMakeFiles/test_matrix.dir/test_tprofile.cpp.o.d"
+  "CMakeFiles/test_matrix.dir/test_tsolvers.cpp.o"
+  "CMakeFiles/test_matrix.dir/test_tsolvers.cpp.o.d"
+  "CMakeFiles/test_matrix.dir/test_tsparse.cpp.o"
+  "CMakeFiles/test_matrix.dir/test_tsparse.cpp.o.d"
+  "CMakeFiles/test_matrix.dir/test_tstrassen.cpp.o"
+  "CMakeFiles/test_matrix.dir/test_tstrassen.cpp.o.d"
+  "CMakeFiles/test_matrix.dir/test_tvector.cpp.o"
+  "CMakeFiles/test_matrix.dir/test_tvector.cpp.o.d"
+  "test_matrix"
+  "test_matrix.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_matrix.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
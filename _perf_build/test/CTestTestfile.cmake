@@ -0,0 +1,16 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/test
+# Build directory: /root/repo/_perf_build/test
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(test_matrix "test_matrix")
+set_tests_properties(test_matrix PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;9;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(test_matrix_isa_scalar "/root/repo/_perf_build/test/test_matrix" "--gtest_filter=TDynamicVector*:TDynamicMatrix*:TKernels*:TBlas*")
+set_tests_properties(test_matrix_isa_scalar PROPERTIES  ENVIRONMENT "TMATRIX_ISA=scalar" _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;14;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(test_matrix_isa_sse4.2 "/root/repo/_perf_build/test/test_matrix" "--gtest_filter=TDynamicVector*:TDynamicMatrix*:TKernels*:TBlas*")
+set_tests_properties(test_matrix_isa_sse4.2 PROPERTIES  ENVIRONMENT "TMATRIX_ISA=sse4.2" _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;14;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(test_matrix_isa_avx2 "/root/repo/_perf_build/test/test_matrix" "--gtest_filter=TDynamicVector*:TDynamicMatrix*:TKernels*:TBlas*")
+set_tests_properties(test_matrix_isa_avx2 PROPERTIES  ENVIRONMENT "TMATRIX_ISA=avx2" _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;14;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(test_matrix_isa_avx512 "/root/repo/_perf_build/test/test_matrix" "--gtest_filter=TDynamicVector*:TDynamicMatrix*:TKernels*:TBlas*")
+set_tests_properties(test_matrix_isa_avx512 PROPERTIES  ENVIRONMENT "TMATRIX_ISA=avx512" _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;14;add_test;/root/repo/test/CMakeLists.txt;0;")
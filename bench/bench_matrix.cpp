@@ -0,0 +1,365 @@
+// ННГУ, ИИТММ, Курс "Алгоритмы и структуры данных"
+//
+// Микробенчмарки операций над векторами и матрицами
+//
+// bench_matrix [--format json|csv] [--sizes 64,128,...] [--reps N] [--warmup N]
+//              [--filter name1,prefix*,...] [--out file]
+// bench_matrix --update baseline.json [--tolerance 0.25] [--sizes ...] [--filter ...]
+//   записать базовый файл для регрессионного теста
+// bench_matrix --compare baseline.json
+//   прогнать записанные в базовом файле бенчмарки; код возврата 1 при замедлении
+//   медианы больше допустимого для записи
+// bench_matrix --tune tmatrix_tuning.cfg [--sizes n] [--reps N]
+//   подобрать размеры блоков и пороги распараллеливания умножения (tgemm.h)
+//   на матрицах n x n (по умолчанию 384) и записать файл настройки
+//
+// n - размер матрицы; векторные операции выполняются над векторами длины n*n
+//
+// strassen_c<порог> сравнивается с matmul для выбора strassen_min, например
+//   bench_matrix --sizes 512,1024,2048 --filter matmul,strassen* --format csv
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include "tbench.h"
+#include "tblas.h"
+#include "tlinalg.h"
+#include "tmatrix.h"
+#include "tmatrix_io.h"
+#include "tstrassen.h"
+
+namespace
+{
+  void fill(TDynamicMatrix<double>& m, double seed)
+  {
+    for (size_t i = 0; i < m.size(); i++)
+      for (size_t j = 0; j < m.size(); j++)
+        m[i][j] = seed + double((i * 31 + j * 17) % 101) / 101.0;
+  }
+
+  void fill(TDynamicVector<double>& v, double seed)
+  {
+    for (size_t i = 0; i < v.size(); i++)
+      v[i] = seed + double(i % 101) / 101.0;
+  }
+
+  vector<size_t> parse_sizes(const char* arg)
+  {
+    vector<size_t> sizes;
+    for (const char* p = arg; *p;)
+    {
+      char* e;
+      const unsigned long v = strtoul(p, &e, 10);
+      if (e == p)
+        break;
+      sizes.push_back(size_t(v));
+      p = *e == ',' ? e + 1 : e;
+    }
+    return sizes;
+  }
+
+  vector<string> parse_names(const string& arg)
+  {
+    vector<string> names;
+    for (size_t b = 0; b <= arg.size();)
+    {
+      const size_t e = min(arg.find(',', b), arg.size());
+      if (e > b)
+        names.push_back(arg.substr(b, e - b));
+      b = e + 1;
+    }
+    return names;
+  }
+
+  // имя совпадает с элементом фильтра целиком; элемент "prefix*" - по началу имени
+  bool matches(const string& name, const vector<string>& filter)
+  {
+    if (filter.empty())
+      return true;
+    for (const string& f : filter)
+      if ((!f.empty() && f.back() == '*') ? name.compare(0, f.size() - 1, f, 0, f.size() - 1) == 0 : name == f)
+        return true;
+    return false;
+  }
+
+  shared_ptr<TDynamicMatrix<double>> make_matrix(size_t n, double seed)
+  {
+    auto m = make_shared<TDynamicMatrix<double>>(n);
+    fill(*m, seed);
+    return m;
+  }
+
+  shared_ptr<TDynamicVector<double>> make_vector(size_t n, double seed)
+  {
+    auto v = make_shared<TDynamicVector<double>>(n);
+    fill(*v, seed);
+    return v;
+  }
+
+  // диагональное преобладание для LU и треугольных систем
+  shared_ptr<TDynamicMatrix<double>> make_system(size_t n)
+  {
+    auto m = make_matrix(n, 1.0);
+    for (size_t i = 0; i < n; i++)
+      (*m)[i][i] += double(n);
+    return m;
+  }
+
+  // симметричная с диагональным преобладанием
+  shared_ptr<TDynamicMatrix<double>> make_spd(size_t n)
+  {
+    auto m = make_shared<TDynamicMatrix<double>>(n);
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < n; j++)
+        (*m)[i][j] = i == j ? double(n) : 1.0 / double(1 + i + j);
+    return m;
+  }
+
+  // 2n x n для наименьших квадратов
+  shared_ptr<TDynamicVector<TDynamicVector<double>>> make_tall(size_t n)
+  {
+    const auto a = make_matrix(n, 1.0);
+    auto m = make_shared<TDynamicVector<TDynamicVector<double>>>(2 * n);
+    for (size_t i = 0; i < 2 * n; i++)
+    {
+      (*m)[i] = (*a)[i % n];
+      (*m)[i][i % n] += double(n);
+    }
+    return m;
+  }
+
+  // текстовое представление матрицы; bytes - его размер
+  shared_ptr<string> make_text(size_t n, double& bytes)
+  {
+    ostringstream out;
+    out << *make_matrix(n, 1.0);
+    auto text = make_shared<string>(out.str());
+    bytes = double(text->size());
+    return text;
+  }
+
+  // все бенчмарки для матрицы размера n; данные каждого готовятся только при его запуске
+  vector<TBenchCase> make_cases(size_t n)
+  {
+    const double d = sizeof(double), nn = double(n) * double(n);
+    vector<TBenchCase> cases;
+    cases.push_back({ "matrix_construct", n, 0, nn * d, [n](double&) {
+      return [n] { TDynamicMatrix<double> m(n); do_not_optimize(m); }; } });
+    cases.push_back({ "matrix_copy", n, 0, 2 * nn * d, [n](double&) {
+      return [a = make_matrix(n, 1.0)] { TDynamicMatrix<double> m(*a); do_not_optimize(m); }; } });
+    cases.push_back({ "vector_add", n, nn, 3 * nn * d, [n](double&) {
+      return [x = make_vector(n * n, 1.0), y = make_vector(n * n, 2.0)] {
+        TDynamicVector<double> r = *x + *y; do_not_optimize(r); }; } });
+    cases.push_back({ "vector_sub", n, nn, 3 * nn * d, [n](double&) {
+      return [x = make_vector(n * n, 1.0), y = make_vector(n * n, 2.0)] {
+        TDynamicVector<double> r = *x - *y; do_not_optimize(r); }; } });
+    cases.push_back({ "vector_scale", n, nn, 2 * nn * d, [n](double&) {
+      return [x = make_vector(n * n, 1.0)] { TDynamicVector<double> r = *x * 1.5; do_not_optimize(r); }; } });
+    cases.push_back({ "vector_dot", n, 2 * nn, 2 * nn * d, [n](double&) {
+      return [x = make_vector(n * n, 1.0), y = make_vector(n * n, 2.0)] {
+        double r = *x * *y; do_not_optimize(r); }; } });
+    cases.push_back({ "vector_axpy", n, 2 * nn, 3 * nn * d, [n](double&) {
+      return [x = make_vector(n * n, 1.0), acc = make_vector(n * n, 2.0)] {
+        axpy(1e-3, *x, *acc); do_not_optimize(*acc); }; } });
+    cases.push_back({ "matrix_add", n, nn, 3 * nn * d, [n](double&) {
+      return [a = make_matrix(n, 1.0), b = make_matrix(n, 2.0)] {
+        TDynamicMatrix<double> r = *a + *b; do_not_optimize(r); }; } });
+    cases.push_back({ "matrix_scale", n, nn, 2 * nn * d, [n](double&) {
+      return [a = make_matrix(n, 1.0)] { TDynamicMatrix<double> r = *a * 1.5; do_not_optimize(r); }; } });
+    cases.push_back({ "matvec", n, 2 * nn, (nn + 2 * double(n)) * d, [n](double&) {
+      return [a = make_matrix(n, 1.0), v = make_vector(n, 3.0)] {
+        TDynamicVector<double> r = *a * *v; do_not_optimize(r); }; } });
+    cases.push_back({ "matmul", n, 2 * nn * double(n), 3 * nn * d, [n](double&) {
+      return [a = make_matrix(n, 1.0), b = make_matrix(n, 2.0)] {
+        TDynamicMatrix<double> r = *a * *b; do_not_optimize(r); }; } });
+    // результат в существующую матрицу, C = A B + 0 C: без выделения памяти и обнуления
+    cases.push_back({ "gemm", n, 2 * nn * double(n), 3 * nn * d, [n](double&) {
+      return [a = make_matrix(n, 1.0), b = make_matrix(n, 2.0), c = make_shared<TDynamicMatrix<double>>(n)] {
+        gemm(1.0, *a, *b, 0.0, *c); do_not_optimize(*c); }; } });
+    cases.push_back({ "matmul_recursive", n, 2 * nn * double(n), 3 * nn * d, [n](double&) {
+      return [a = make_matrix(n, 1.0), b = make_matrix(n, 2.0)] {
+        TDynamicMatrix<double> r = multiply_recursive(*a, *b); do_not_optimize(r); }; } });
+    // порог рекурсии Штрассена; GFLOP/s - в пересчёте на 2 n^3 обычного умножения
+    for (size_t crossover : { 128, 256, 512 })
+      cases.push_back({ "strassen_c" + to_string(crossover), n, 2 * nn * double(n), 3 * nn * d, [n, crossover](double&) {
+        return [a = make_matrix(n, 1.0), b = make_matrix(n, 2.0), s = make_shared<TStrassen<double>>(crossover),
+          r = make_shared<TDynamicMatrix<double>>(n)] { s->multiply(*a, *b, *r); do_not_optimize(*r); }; } });
+    cases.push_back({ "lu_factor", n, 2.0 / 3.0 * nn * double(n), 2 * nn * d, [n](double&) {
+      return [sys = make_system(n)] { TLU<double> lu(*sys); do_not_optimize(lu); }; } });
+    cases.push_back({ "lu_solve", n, 2 * nn, (nn + 2 * double(n)) * d, [n](double&) {
+      return [lu = make_shared<TLU<double>>(*make_system(n)), v = make_vector(n, 3.0)] {
+        TDynamicVector<double> r = lu->solve(*v); do_not_optimize(r); }; } });
+    cases.push_back({ "cholesky_factor", n, nn * double(n) / 3.0, nn * d, [n](double&) {
+      return [spd = make_spd(n)] { TCholesky<double> ch(*spd); do_not_optimize(ch); }; } });
+    cases.push_back({ "trsm", n, nn * double(n), 3 * nn * d, [n](double&) {
+      return [sys = make_system(n), b = make_matrix(n, 2.0)] {
+        TDynamicMatrix<double> x(*b); trsm(*sys, x, TRI_LOWER); do_not_optimize(x); }; } });
+    cases.push_back({ "qr_lstsq", n, 10.0 / 3.0 * nn * double(n), 3 * nn * d, [n](double&) {
+      return [tall = make_tall(n), y2 = make_shared<TDynamicVector<double>>(2 * n)] {
+        TDynamicVector<double> r = lstsq(*tall, *y2); do_not_optimize(r); }; } });
+    cases.push_back({ "io_write_text", n, 0, 0, [n](double& bytes) {
+      make_text(n, bytes);
+      return [a = make_matrix(n, 1.0)] { ostringstream out; out << *a; do_not_optimize(out); }; } });
+    cases.push_back({ "io_read_text", n, 0, 0, [n](double& bytes) {
+      return [n, text = make_text(n, bytes)] {
+        istringstream in(*text); TDynamicMatrix<double> m(n); in >> m; do_not_optimize(m); }; } });
+    cases.push_back({ "io_load_text", n, 0, 0, [n](double& bytes) {
+      return [n, text = make_text(n, bytes)] {
+        TDynamicMatrix<double> m(n); load_text(text->data(), text->size(), m); do_not_optimize(m); }; } });
+    cases.push_back({ "io_write_npy", n, 0, nn * d, [n](double&) {
+      return [a = make_matrix(n, 1.0)] { ostringstream out; npy_write(out, *a); do_not_optimize(out); }; } });
+    cases.push_back({ "io_read_npy", n, 0, nn * d, [n](double&) {
+      ostringstream out;
+      npy_write(out, *make_matrix(n, 1.0));
+      return [npy = make_shared<string>(out.str())] {
+        istringstream in(*npy); TDynamicMatrix<double> m; npy_read(in, m); do_not_optimize(m); }; } });
+    return cases;
+  }
+
+  int compare_with_baseline(const string& path, size_t warmup, size_t reps)
+  {
+    ifstream f(path);
+    if (!f)
+    {
+      cerr << "Can't open " << path << endl;
+      return 2;
+    }
+    const vector<TBaselineEntry> baseline = read_baseline(f);
+    if (baseline.empty())
+    {
+      cerr << "No benchmarks in " << path << endl;
+      return 2;
+    }
+    TBenchRunner runner(warmup, reps);
+    int failed = 0;
+    vector<TBenchCase> cases;
+    size_t cases_n = 0;
+    for (const TBaselineEntry& e : baseline)
+    {
+      if (cases.empty() || cases_n != e.n)
+      {
+        cases = make_cases(e.n);
+        cases_n = e.n;
+      }
+      auto c = find_if(cases.begin(), cases.end(), [&e](const TBenchCase& x) { return x.name == e.name; });
+      if (c == cases.end())
+      {
+        cerr << "Unknown benchmark " << e.name << endl;
+        return 2;
+      }
+      const TBenchResult& r = runner.run(*c);
+      const double ratio = r.median_ns / e.median_ns;
+      const bool regressed = ratio > 1 + e.tolerance;
+      char buf[256];
+      snprintf(buf, sizeof(buf), "%-16s n=%-5zu %12.1f ns  baseline %12.1f ns  x%.2f (limit x%.2f)%s",
+        e.name.c_str(), e.n, r.median_ns, e.median_ns, ratio, 1 + e.tolerance, regressed ? "  REGRESSION" : "");
+      cout << buf << endl;
+      failed += regressed;
+    }
+    return failed ? 1 : 0;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  string format = "json", out_path, compare_path, update_path, tune_path;
+  vector<string> filter;
+  vector<size_t> sizes = { 64, 128, 256, 512 };
+  size_t reps = 10, warmup = 2;
+  double tolerance = 0.25;
+  for (int i = 1; i < argc; i++)
+  {
+    const string arg = argv[i];
+    const char* val = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (val == nullptr)
+    {
+      cerr << "Missing value for " << arg << endl;
+      return 2;
+    }
+    if (arg == "--format")
+      format = val;
+    else if (arg == "--sizes")
+      sizes = parse_sizes(val);
+    else if (arg == "--reps")
+      reps = size_t(strtoul(val, nullptr, 10));
+    else if (arg == "--warmup")
+      warmup = size_t(strtoul(val, nullptr, 10));
+    else if (arg == "--filter")
+      filter = parse_names(val);
+    else if (arg == "--out")
+      out_path = val;
+    else if (arg == "--compare")
+      compare_path = val;
+    else if (arg == "--update")
+      update_path = val;
+    else if (arg == "--tune")
+      tune_path = val;
+    else if (arg == "--tolerance")
+      tolerance = strtod(val, nullptr);
+    else
+    {
+      cerr << "Unknown option " << arg << endl;
+      return 2;
+    }
+    i++;
+  }
+  if (format != "json" && format != "csv")
+  {
+    cerr << "Unknown format " << format << endl;
+    return 2;
+  }
+  if (!compare_path.empty())
+    return compare_with_baseline(compare_path, warmup, reps);
+  if (!tune_path.empty())
+  {
+    ofstream f(tune_path);
+    if (!f)
+    {
+      cerr << "Can't open " << tune_path << endl;
+      return 1;
+    }
+    const size_t n = sizes.size() == 1 ? sizes[0] : 384;
+    write_gemm_params(f, autotune_gemm(n, max<size_t>(reps / 3, 1), &cerr));
+    return 0;
+  }
+
+  TBenchRunner runner(warmup, reps);
+  for (size_t n : sizes)
+    for (const TBenchCase& c : make_cases(n))
+      if (matches(c.name, filter))
+      {
+        const TBenchResult& r = runner.run(c);
+        cerr << r.name << " n=" << r.n << ": " << r.median_ns / 1e6 << " ms" << endl;
+      }
+
+  if (!update_path.empty())
+  {
+    ofstream f(update_path);
+    if (!f)
+    {
+      cerr << "Can't open " << update_path << endl;
+      return 1;
+    }
+    runner.write_json(f, tolerance);
+    return 0;
+  }
+
+  ofstream file;
+  if (!out_path.empty())
+  {
+    file.open(out_path);
+    if (!file)
+    {
+      cerr << "Can't open " << out_path << endl;
+      return 1;
+    }
+  }
+  ostream& out = out_path.empty() ? cout : file;
+  if (format == "json")
+    runner.write_json(out);
+  else
+    runner.write_csv(out);
+  return 0;
+}
@@ -0,0 +1,191 @@
+// ННГУ, ИИТММ, Курс "Алгоритмы и структуры данных"
+//
+// Простой каркас микробенчмарков: прогрев, повторы, медиана/p99,
+// GFLOP/s и GB/s, вывод в JSON или CSV, сравнение с базовым файлом
+//
+
+#ifndef __TBench_H__
+#define __TBench_H__
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// не дать компилятору выбросить вычисление результата
+template<typename T>
+inline void do_not_optimize(const T& val)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "g"(&val) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &val;
+#endif
+}
+
+struct TBenchResult
+{
+  string name;
+  size_t n;
+  size_t reps;
+  size_t batch;     // вызовов на один замер
+  double median_ns; // время одного вызова
+  double p99_ns;
+  double min_ns;
+  double gflops;
+  double gbps;
+};
+
+// запись базового файла: допустимое замедление медианы - tolerance (доля)
+struct TBaselineEntry
+{
+  string name;
+  size_t n;
+  double median_ns;
+  double tolerance;
+};
+
+struct TBenchCase
+{
+  string name;
+  size_t n;
+  double flops;  // арифметических операций на вызов
+  double bytes;  // байт памяти на вызов (чтение + запись)
+  // готовит данные и возвращает измеряемую функцию; вызывается только для
+  // запускаемых бенчмарков, bytes уточняется, если объём зависит от данных
+  function<function<void()>(double& bytes)> setup;
+};
+
+class TBenchRunner
+{
+  size_t warmup;
+  size_t reps;
+  double min_sample_ns;
+  vector<TBenchResult> results;
+
+  static double now_ns()
+  {
+    using namespace chrono;
+    return double(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+  }
+public:
+  TBenchRunner(size_t warmup_ = 2, size_t reps_ = 10, double min_sample_ns_ = 2e5)
+    : warmup(warmup_), reps(max<size_t>(reps_, 1)), min_sample_ns(min_sample_ns_) {}
+
+  const vector<TBenchResult>& get_results() const noexcept { return results; }
+
+  const TBenchResult& run(const TBenchCase& c)
+  {
+    double bytes = c.bytes;
+    const function<void()> body = c.setup(bytes);
+    // калибровка: короткие операции группируются так, чтобы замер был не меньше min_sample_ns
+    double t0 = now_ns();
+    body();
+    const double once = max(now_ns() - t0, 1.0);
+    const size_t batch = once >= min_sample_ns ? 1 : size_t(min_sample_ns / once) + 1;
+    for (size_t w = 0; w < warmup; w++)
+      for (size_t b = 0; b < batch; b++)
+        body();
+
+    vector<double> samples(reps);
+    for (size_t r = 0; r < reps; r++)
+    {
+      t0 = now_ns();
+      for (size_t b = 0; b < batch; b++)
+        body();
+      samples[r] = (now_ns() - t0) / double(batch);
+    }
+    sort(samples.begin(), samples.end());
+
+    TBenchResult res;
+    res.name = c.name;
+    res.n = c.n;
+    res.reps = reps;
+    res.batch = batch;
+    res.median_ns = reps % 2 ? samples[reps / 2] : (samples[reps / 2 - 1] + samples[reps / 2]) / 2;
+    res.p99_ns = samples[min(reps - 1, size_t(0.99 * double(reps - 1) + 0.5))];
+    res.min_ns = samples.front();
+    res.gflops = c.flops / res.median_ns;
+    res.gbps = bytes / res.median_ns;
+    results.push_back(res);
+    return results.back();
+  }
+
+  // tolerance >= 0 добавляется к каждой записи (формат базового файла)
+  void write_json(ostream& ostr, double tolerance = -1) const
+  {
+    ostr << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+      const TBenchResult& r = results[i];
+      char buf[512];
+      snprintf(buf, sizeof(buf),
+        "    {\"name\": \"%s\", \"n\": %zu, \"reps\": %zu, \"batch\": %zu, \"median_ns\": %.1f, "
+        "\"p99_ns\": %.1f, \"min_ns\": %.1f, \"gflops\": %.4f, \"gbps\": %.4f",
+        r.name.c_str(), r.n, r.reps, r.batch, r.median_ns, r.p99_ns, r.min_ns, r.gflops, r.gbps);
+      ostr << buf;
+      if (tolerance >= 0)
+      {
+        snprintf(buf, sizeof(buf), ", \"tolerance\": %.2f", tolerance);
+        ostr << buf;
+      }
+      ostr << '}' << (i + 1 < results.size() ? "," : "") << '\n';
+    }
+    ostr << "  ]\n}\n";
+  }
+  void write_csv(ostream& ostr) const
+  {
+    ostr << "name,n,reps,batch,median_ns,p99_ns,min_ns,gflops,gbps\n";
+    for (const TBenchResult& r : results)
+    {
+      char buf[512];
+      snprintf(buf, sizeof(buf), "%s,%zu,%zu,%zu,%.1f,%.1f,%.1f,%.4f,%.4f\n", r.name.c_str(), r.n,
+        r.reps, r.batch, r.median_ns, r.p99_ns, r.min_ns, r.gflops, r.gbps);
+      ostr << buf;
+    }
+  }
+};
+
+// чтение базового файла в формате write_json (по одному объекту на строку)
+inline vector<TBaselineEntry> read_baseline(istream& istr)
+{
+  auto field = [](const string& line, const char* key, string& val) {
+    const size_t k = line.find(string("\"") + key + "\":");
+    if (k == string::npos)
+      return false;
+    size_t b = k + strlen(key) + 3;
+    while (b < line.size() && line[b] == ' ')
+      b++;
+    if (b < line.size() && line[b] == '"')
+    {
+      const size_t e = line.find('"', b + 1);
+      val = line.substr(b + 1, e - b - 1);
+    }
+    else
+      val = line.substr(b, line.find_first_of(",}", b) - b);
+    return true;
+  };
+  vector<TBaselineEntry> entries;
+  string line, name, n, median, tol;
+  while (getline(istr, line))
+    if (field(line, "name", name) && field(line, "n", n) && field(line, "median_ns", median))
+    {
+      TBaselineEntry e;
+      e.name = name;
+      e.n = size_t(strtoul(n.c_str(), nullptr, 10));
+      e.median_ns = strtod(median.c_str(), nullptr);
+      e.tolerance = field(line, "tolerance", tol) ? strtod(tol.c_str(), nullptr) : 0.25;
+      entries.push_back(e);
+    }
+  return entries;
+}
+
+#endif
@@ -0,0 +1,121 @@
+// ННГУ, ИИТММ, Курс "Алгоритмы и структуры данных"
+//
+// Операции над векторами и матрицами на месте (уровни 1-3 BLAS)
+//
+// В отличие от операторов TDynamicVector и TDynamicMatrix, не создают временных
+// векторов и матриц: y = y + x * a через операторы - два выделения памяти и три
+// прохода, axpy(a, x, y) - один проход ядром текущего набора инструкций.
+// gemv и gemm пишут результат в переданный вектор/матрицу, множители alpha
+// и beta учитываются внутри ядер без отдельных проходов; указатели на строки
+// матриц не копируются в отдельные массивы, и при последовательном выполнении
+// (размеры меньше порогов распараллеливания) память не выделяется
+//
+
+#ifndef __TBlas_H__
+#define __TBlas_H__
+
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+#include "tgemm.h"
+#include "tkernels.h"
+#include "tmatrix.h"
+
+using namespace std;
+
+namespace tmatrix_detail
+{
+  template<typename T>
+  void check_sizes(const TDynamicVector<T>& x, const TDynamicVector<T>& y)
+  {
+    if (x.size() != y.size())
+      throw length_error("Vectors should have equal sizes");
+  }
+}
+
+// y += a x
+template<typename T>
+void axpy(T a, const TDynamicVector<T>& x, TDynamicVector<T>& y)
+{
+  tmatrix_detail::check_sizes(x, y);
+  const size_t n = x.size();
+  TMATRIX_OP(OP_ADD, n, 2 * n, 2 * n * sizeof(T), n * sizeof(T));
+  kernels<T>().axpy(&y[0], &x[0], a, n);
+}
+
+// y = a x + b y
+template<typename T>
+void axpby(T a, const TDynamicVector<T>& x, T b, TDynamicVector<T>& y)
+{
+  tmatrix_detail::check_sizes(x, y);
+  const size_t n = x.size();
+  TMATRIX_OP(OP_ADD, n, 3 * n, 2 * n * sizeof(T), n * sizeof(T));
+  kernels<T>().axpby(&y[0], &x[0], a, b, n);
+}
+
+// x *= a
+template<typename T>
+void scal(T a, TDynamicVector<T>& x)
+{
+  const size_t n = x.size();
+  TMATRIX_OP(OP_SCALE, n, n, n * sizeof(T), n * sizeof(T));
+  kernels<T>().scale(&x[0], a, n);
+}
+
+template<typename T>
+T dot(const TDynamicVector<T>& x, const TDynamicVector<T>& y)
+{
+  tmatrix_detail::check_sizes(x, y);
+  const size_t n = x.size();
+  TMATRIX_OP(OP_DOT, n, 2 * n, 2 * n * sizeof(T), 0);
+  return kernels<T>().dot(&x[0], &y[0], n);
+}
+
+// евклидова норма; без масштабирования, как sqrt(x x)
+template<typename T>
+T nrm2(const TDynamicVector<T>& x)
+{
+  static_assert(is_floating_point<T>::value, "nrm2 requires a floating point element type");
+  const size_t n = x.size();
+  TMATRIX_OP(OP_DOT, n, 2 * n, n * sizeof(T), 0);
+  return sqrt(kernels<T>().dot(&x[0], &x[0], n));
+}
+
+// y += a x; возвращает y y нового y (обновление невязки и её норма за один проход)
+template<typename T>
+T axpy_dot(T a, const TDynamicVector<T>& x, TDynamicVector<T>& y)
+{
+  tmatrix_detail::check_sizes(x, y);
+  const size_t n = x.size();
+  TMATRIX_OP(OP_ADD, n, 4 * n, 2 * n * sizeof(T), n * sizeof(T));
+  return kernels<T>().axpy_dot(&y[0], &x[0], a, n);
+}
+
+// y = alpha A x + beta y; при beta = 0 прежнее содержимое y не читается
+template<typename T>
+void gemv(T alpha, const TDynamicMatrix<T>& a, const TDynamicVector<T>& x, T beta, TDynamicVector<T>& y)
+{
+  const size_t n = a.size();
+  if (x.size() != n || y.size() != n)
+    throw length_error("Matrix and vector sizes should match");
+  if (&x == &y)
+    throw invalid_argument("Result vector should not be the argument vector");
+  TMATRIX_OP(OP_MATVEC, n, 2 * n * n, (n * n + 2 * n) * sizeof(T), n * sizeof(T));
+  gemv_rows(alpha, a, &x[0], beta, &y[0], n, n);
+}
+
+// C = alpha A B + beta C; при beta = 0 прежнее содержимое C не читается
+template<typename T>
+void gemm(T alpha, const TDynamicMatrix<T>& a, const TDynamicMatrix<T>& b, T beta, TDynamicMatrix<T>& c)
+{
+  const size_t n = a.size();
+  if (b.size() != n || c.size() != n)
+    throw length_error("Matrices should have equal sizes");
+  if (&c == &a || &c == &b)
+    throw invalid_argument("Result matrix should not be an argument matrix");
+  TMATRIX_OP(OP_MATMUL, n, 2 * n * n * n, 3 * n * n * sizeof(T), n * n * sizeof(T));
+  gemm_rows(alpha, a, b, beta, c, n, n, n);
+}
+
+#endif
@@ -0,0 +1,478 @@
+// ННГУ, ИИТММ, Курс "Алгоритмы и структуры данных"
+//
+// Блочное параллельное умножение матриц и матрицы на вектор,
+// настройка размеров блоков и порогов распараллеливания под процессор
+//
+// Параметры читаются при первом умножении из файла, заданного переменной окружения
+// TMATRIX_TUNING_FILE (без неё - значения по умолчанию), или явно load_gemm_params;
+// файл записывается bench_matrix --tune <файл>. Формат - строки "ключ = значение",
+// '#' - комментарий
+//
+
+#ifndef __TGemm_H__
+#define __TGemm_H__
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "tkernels.h"
+#include "tparallel.h"
+
+using namespace std;
+
+struct TGemmParams
+{
+  size_t block_m = 64;       // строк C в блоке
+  size_t block_k = 256;      // глубина блока (строк B)
+  size_t block_n = 512;      // столбцов C в блоке
+  size_t par_min_gemm = 96;  // с какого размера n x n умножение матриц выполняется параллельно
+  size_t par_min_gemv = 512; // с какого размера n x n умножение на вектор выполняется параллельно
+  size_t strassen_min = 512; // блоки не больше этого размера tstrassen.h умножает без рекурсии
+
+  bool operator==(const TGemmParams& p) const noexcept
+  {
+    return block_m == p.block_m && block_k == p.block_k && block_n == p.block_n &&
+      par_min_gemm == p.par_min_gemm && par_min_gemv == p.par_min_gemv && strassen_min == p.strassen_min;
+  }
+  bool operator!=(const TGemmParams& p) const noexcept { return !(*this == p); }
+};
+
+namespace tmatrix_detail
+{
+  inline string trim(const string& s)
+  {
+    const size_t b = s.find_first_not_of(" \t\r");
+    if (b == string::npos)
+      return string();
+    return s.substr(b, s.find_last_not_of(" \t\r") - b + 1);
+  }
+}
+
+// чтение параметров; неизвестные ключи пропускаются
+inline TGemmParams read_gemm_params(istream& istr)
+{
+  TGemmParams p;
+  string line;
+  while (getline(istr, line))
+  {
+    line = tmatrix_detail::trim(line.substr(0, line.find('#')));
+    if (line.empty())
+      continue;
+    const size_t eq = line.find('=');
+    if (eq == string::npos)
+      throw invalid_argument("gemm params: expected key = value");
+    const string key = tmatrix_detail::trim(line.substr(0, eq));
+    const string val = tmatrix_detail::trim(line.substr(eq + 1));
+    char* end;
+    const unsigned long long v = strtoull(val.c_str(), &end, 10);
+    if (val.empty() || *end != '\0' || v == 0)
+      throw invalid_argument("gemm params: bad value for " + key);
+    if (key == "block_m")
+      p.block_m = size_t(v);
+    else if (key == "block_k")
+      p.block_k = size_t(v);
+    else if (key == "block_n")
+      p.block_n = size_t(v);
+    else if (key == "par_min_gemm")
+      p.par_min_gemm = size_t(v);
+    else if (key == "par_min_gemv")
+      p.par_min_gemv = size_t(v);
+    else if (key == "strassen_min")
+      p.strassen_min = size_t(v);
+  }
+  return p;
+}
+
+inline void write_gemm_params(ostream& ostr, const TGemmParams& p)
+{
+  ostr << "# tmatrix gemm tuning\n"
+    << "block_m = " << p.block_m << '\n'
+    << "block_k = " << p.block_k << '\n'
+    << "block_n = " << p.block_n << '\n'
+    << "par_min_gemm = " << p.par_min_gemm << '\n'
+    << "par_min_gemv = " << p.par_min_gemv << '\n'
+    << "strassen_min = " << p.strassen_min << '\n';
+}
+
+namespace tmatrix_detail
+{
+  // параметры из файла TMATRIX_TUNING_FILE; без переменной, при отсутствии файла
+  // или ошибке в нём - значения по умолчанию
+  inline TGemmParams load_startup_params()
+  {
+    const char* env = getenv("TMATRIX_TUNING_FILE");
+    if (env == nullptr)
+      return TGemmParams();
+    ifstream f(env);
+    if (!f)
+      return TGemmParams();
+    try
+    {
+      return read_gemm_params(f);
+    }
+    catch (const invalid_argument&)
+    {
+      return TGemmParams();
+    }
+  }
+
+  // текущие параметры; читаются и заменяются целиком под мьютексом
+  struct TGemmParamsState
+  {
+    mutex mtx;
+    TGemmParams params;
+    TGemmParamsState() : params(load_startup_params()) {}
+  };
+
+  inline TGemmParamsState& gemm_params_state()
+  {
+    static TGemmParamsState state;
+    return state;
+  }
+}
+
+// копия текущих параметров умножения (безопасно при одновременном set_gemm_params)
+inline TGemmParams gemm_params()
+{
+  tmatrix_detail::TGemmParamsState& st = tmatrix_detail::gemm_params_state();
+  lock_guard<mutex> lock(st.mtx);
+  return st.params;
+}
+
+inline void set_gemm_params(const TGemmParams& p)
+{
+  if (p.block_m == 0 || p.block_k == 0 || p.block_n == 0)
+    throw invalid_argument("gemm params: block size must be positive");
+  tmatrix_detail::TGemmParamsState& st = tmatrix_detail::gemm_params_state();
+  lock_guard<mutex> lock(st.mtx);
+  st.params = p;
+}
+
+// параметры из файла настройки; исключение, если файл не открывается или содержит ошибку
+inline void load_gemm_params(const string& path)
+{
+  ifstream f(path);
+  if (!f)
+    throw runtime_error("Can't open gemm tuning file " + path);
+  set_gemm_params(read_gemm_params(f));
+}
+
+namespace tmatrix_detail
+{
+  // строка i источника строк: массива указателей на строки или матрицы,
+  // у которой rows[i][0] - первый элемент строки i
+  template<typename R>
+  auto row_at(R&& rows, size_t i)
+  {
+    if constexpr (is_pointer<decay_t<R>>::value)
+      return rows[i];
+    else
+      return &rows[i][0];
+  }
+
+  // тип элементов источника строк
+  template<typename R>
+  using row_elem_t = remove_const_t<remove_pointer_t<decltype(row_at(declval<R&>(), 0))>>;
+}
+
+// C = alpha A B + beta C, A (m x k), B (k x n), C (m x n) - массивы указателей на строки
+// или матрицы TDynamicMatrix (указатели на строки берутся по мере надобности, без
+// выделения памяти); блоки строк C распределяются между потоками пула.
+// Масштабирование C на beta выполняется для каждого блока C перед первым умножением
+// в него, пока блок в кэше; при beta = 0 прежнее содержимое C не читается
+template<typename T, typename RA, typename RB, typename RC>
+void gemm_rows(T alpha, const RA& a, const RB& b, T beta, RC&& c, size_t m, size_t k, size_t n,
+  const TGemmParams& p = gemm_params())
+{
+  using tmatrix_detail::row_at;
+  const TKernelTable<T>& kern = kernels<T>();
+  const size_t bm = p.block_m, bk = p.block_k, bn = p.block_n;
+  auto rows = [&](size_t ib, size_t ie) {
+    // указатели блоков; после первого вызова в потоке память не выделяется
+    thread_local vector<const T*> at, bt;
+    thread_local vector<T*> ct;
+    at.resize(max(at.size(), bm));
+    bt.resize(max(bt.size(), bk));
+    ct.resize(max(ct.size(), bm));
+    for (size_t j0 = 0; j0 < n; j0 += bn)
+    {
+      const size_t nj = min(bn, n - j0);
+      // при k = 0 один проход с nl = 0: только масштабирование C
+      for (size_t l0 = 0; l0 < k || l0 == 0; l0 += bk)
+      {
+        const size_t nl = min(bk, k - l0);
+        for (size_t l = 0; l < nl; l++)
+          bt[l] = row_at(b, l0 + l) + j0;
+        for (size_t i0 = ib * bm; i0 < min(ie * bm, m); i0 += bm)
+        {
+          const size_t ni = min(bm, m - i0);
+          for (size_t i = 0; i < ni; i++)
+          {
+            at[i] = row_at(a, i0 + i) + l0;
+            ct[i] = row_at(c, i0 + i) + j0;
+          }
+          if (l0 == 0 && beta == T())
+          {
+            for (size_t i = 0; i < ni; i++)
+              fill(ct[i], ct[i] + nj, T());
+          }
+          else if (l0 == 0 && beta != T(1))
+          {
+            for (size_t i = 0; i < ni; i++)
+              kern.scale(ct[i], beta, nj);
+          }
+          if (nl != 0 && alpha != T())
+            kern.matmul(at.data(), bt.data(), ct.data(), ni, nl, nj, alpha);
+        }
+      }
+    }
+  };
+  const double par = double(p.par_min_gemm);
+  if (double(m) * double(n) * double(k) >= par * par * par)
+    parallel_for(0, (m + bm - 1) / bm, 1, rows);
+  else
+    rows(0, (m + bm - 1) / bm);
+}
+
+// C += A B
+template<typename T>
+void gemm_rows(const T* const* a, const T* const* b, T* const* c, size_t m, size_t k, size_t n,
+  const TGemmParams& p = gemm_params())
+{
+  gemm_rows(T(1), a, b, T(1), c, m, k, n, p);
+}
+
+// y = alpha A x + beta y, A (m x n) - массив указателей на строки или матрица;
+// при beta = 0 прежнее содержимое y не читается
+template<typename T, typename RA>
+void gemv_rows(T alpha, const RA& a, const T* x, T beta, T* y, size_t m, size_t n,
+  const TGemmParams& p = gemm_params())
+{
+  const TKernelTable<T>& kern = kernels<T>();
+  auto rows = [&](size_t b, size_t e) {
+    // указатели на строки порциями на стеке
+    const size_t chunk = 64;
+    const T* ar[chunk];
+    for (size_t i0 = b; i0 < e; i0 += chunk)
+    {
+      const size_t ni = min(chunk, e - i0);
+      for (size_t i = 0; i < ni; i++)
+        ar[i] = tmatrix_detail::row_at(a, i0 + i);
+      kern.matvec(ar, x, y + i0, ni, n, alpha, beta);
+    }
+  };
+  const double par = double(p.par_min_gemv);
+  if (double(m) * double(n) >= par * par)
+    parallel_for(0, m, 64, rows);
+  else
+    rows(0, m);
+}
+
+// y = A x
+template<typename T>
+void gemv_rows(const T* const* a, const T* x, T* y, size_t m, size_t n, const TGemmParams& p = gemm_params())
+{
+  gemv_rows(T(1), a, x, T(), y, m, n, p);
+}
+
+namespace tmatrix_detail
+{
+  // подматрица источника строк src: строки с row, столбцы с col
+  template<typename R>
+  struct TSubRows
+  {
+    R& src;
+    size_t row, col;
+    auto at(size_t i) const { return row_at(src, row + i) + col; }
+    TSubRows down(size_t i) const { return { src, row + i, col }; }
+    TSubRows right(size_t j) const { return { src, row, col + j }; }
+  };
+
+  const size_t REC_LEAF = 64;         // наибольшее измерение листа рекурсии
+  const double REC_TASK = 64 * 64 * 64; // объём m k n, начиная с которого половины - отдельные задачи
+
+  template<typename T, typename RA, typename RB, typename RC>
+  void gemm_recursive(TSubRows<RA> a, TSubRows<RB> b, TSubRows<RC> c,
+    size_t m, size_t k, size_t n, const TKernelTable<T>& kern)
+  {
+    if (max(m, max(k, n)) <= REC_LEAF)
+    {
+      const T* ar[REC_LEAF];
+      const T* br[REC_LEAF];
+      T* cr[REC_LEAF];
+      for (size_t i = 0; i < m; i++)
+      {
+        ar[i] = a.at(i);
+        cr[i] = c.at(i);
+      }
+      for (size_t l = 0; l < k; l++)
+        br[l] = b.at(l);
+      kern.matmul(ar, br, cr, m, k, n, T(1));
+      return;
+    }
+    const bool par = double(m) * double(k) * double(n) >= REC_TASK;
+    // две независимые половины C - параллельно, если объём достаточен
+    auto split = [par](auto first, auto second) {
+      if (!par)
+      {
+        first();
+        second();
+        return;
+      }
+      TTaskGroup group;
+      group.run(first);
+      second();
+      group.wait();
+    };
+    if (m >= k && m >= n)
+    {
+      const size_t h = m / 2;
+      split([=, &kern] { gemm_recursive(a, b, c, h, k, n, kern); },
+        [=, &kern] { gemm_recursive(a.down(h), b, c.down(h), m - h, k, n, kern); });
+    }
+    else if (n >= k)
+    {
+      const size_t h = n / 2;
+      split([=, &kern] { gemm_recursive(a, b, c, m, k, h, kern); },
+        [=, &kern] { gemm_recursive(a, b.right(h), c.right(h), m, k, n - h, kern); });
+    }
+    else
+    {
+      // по k обе половины пишут в один блок C - последовательно
+      const size_t h = k / 2;
+      gemm_recursive(a, b, c, m, h, n, kern);
+      gemm_recursive(a.right(h), b.down(h), c, m, k - h, n, kern);
+    }
+  }
+}
+
+// C += A B рекурсивным делением наибольшего измерения пополам: размеры
+// подзадач со временем укладываются в любой уровень кэша без настройки
+// блоков; независимые половины выполняются задачами пула потоков.
+// A, B, C - массивы указателей на строки или матрицы, как в gemm_rows
+template<typename RA, typename RB, typename RC>
+void gemm_recursive_rows(const RA& a, const RB& b, RC&& c, size_t m, size_t k, size_t n)
+{
+  using namespace tmatrix_detail;
+  using T = row_elem_t<const RA>;
+  if (m == 0 || k == 0 || n == 0)
+    return;
+  gemm_recursive<T>(TSubRows<const RA>{ a, 0, 0 }, TSubRows<const RB>{ b, 0, 0 },
+    TSubRows<remove_reference_t<RC>>{ c, 0, 0 }, m, k, n, kernels<T>());
+}
+
+namespace tmatrix_detail
+{
+  // лучшее из reps измерений, нс
+  template<typename F>
+  double time_best(F f, size_t reps)
+  {
+    using namespace chrono;
+    double best = 1e300;
+    for (size_t r = 0; r < reps; r++)
+    {
+      const auto t0 = steady_clock::now();
+      f();
+      best = min(best, double(duration_cast<nanoseconds>(steady_clock::now() - t0).count()));
+    }
+    return best;
+  }
+
+  struct TTuneMatrix
+  {
+    vector<double> data;
+    vector<double*> rows;
+    TTuneMatrix(size_t n) : data(n * n), rows(n)
+    {
+      for (size_t i = 0; i < n; i++)
+      {
+        rows[i] = &data[i * n];
+        for (size_t j = 0; j < n; j++)
+          data[i * n + j] = double((i * 13 + j * 7) % 17) / 17.0;
+      }
+    }
+    const double* const* crows() const { return rows.data(); }
+  };
+
+  // наименьший размер из sizes, начиная с которого параллельный вариант быстрее
+  // последовательного на всех больших размерах
+  template<typename F>
+  size_t tune_threshold(const vector<size_t>& sizes, F run, size_t reps, size_t fallback)
+  {
+    size_t threshold = fallback;
+    for (size_t s = sizes.size(); s-- > 0;)
+    {
+      const double seq = time_best([&] { run(sizes[s], false); }, reps);
+      const double par = time_best([&] { run(sizes[s], true); }, reps);
+      if (par >= seq)
+        break;
+      threshold = sizes[s];
+    }
+    return threshold;
+  }
+}
+
+// Подбор параметров умножения на текущем процессоре: размеры блоков - покоординатным
+// поиском на матрицах n x n, пороги распараллеливания - сравнением с последовательным
+// выполнением (при одном потоке в пуле остаются прежними)
+inline TGemmParams autotune_gemm(size_t n = 384, size_t reps = 3, ostream* log = nullptr)
+{
+  using namespace tmatrix_detail;
+  TGemmParams best = gemm_params();
+  const size_t no_par = size_t(1) << 30;
+  TTuneMatrix a(n), b(n), c(n);
+  auto gemm_time = [&](const TGemmParams& p) {
+    TGemmParams seq = p;
+    seq.par_min_gemm = no_par;
+    return time_best([&] { gemm_rows(a.crows(), b.crows(), c.rows.data(), n, n, n, seq); }, reps);
+  };
+  double best_ns = gemm_time(best);
+  const size_t cand_m[] = { 16, 32, 64, 128 }, cand_k[] = { 64, 128, 256, 512 }, cand_n[] = { 128, 256, 512, 1024 };
+  auto search = [&](size_t TGemmParams::*field, const size_t* cand, size_t count) {
+    for (size_t i = 0; i < count; i++)
+    {
+      TGemmParams p = best;
+      p.*field = cand[i];
+      const double ns = gemm_time(p);
+      if (log != nullptr)
+        *log << "block_m=" << p.block_m << " block_k=" << p.block_k << " block_n=" << p.block_n
+          << ": " << ns / 1e6 << " ms\n";
+      if (ns < best_ns)
+      {
+        best_ns = ns;
+        best = p;
+      }
+    }
+  };
+  search(&TGemmParams::block_k, cand_k, 4);
+  search(&TGemmParams::block_m, cand_m, 4);
+  search(&TGemmParams::block_n, cand_n, 4);
+
+  if (TThreadPool::instance().size() > 1)
+  {
+    const vector<size_t> gemm_sizes = { 32, 48, 64, 96, 128, 192, 256 };
+    best.par_min_gemm = tune_threshold(gemm_sizes, [&](size_t s, bool par) {
+      TGemmParams p = best;
+      p.par_min_gemm = par ? 1 : no_par;
+      s = min(s, n);
+      gemm_rows(a.crows(), b.crows(), c.rows.data(), s, s, s, p);
+    }, reps, no_par);
+    const vector<size_t> gemv_sizes = { 64, 128, 192, 256, 384 };
+    vector<double> y(n);
+    best.par_min_gemv = tune_threshold(gemv_sizes, [&](size_t s, bool par) {
+      TGemmParams p = best;
+      p.par_min_gemv = par ? 1 : no_par;
+      gemv_rows(a.crows(), b.rows[0], y.data(), min(s, n), min(s, n), p);
+    }, reps, no_par);
+  }
+  return best;
+}
+
+#endif
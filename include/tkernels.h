@@ -0,0 +1,301 @@
+// ННГУ, ИИТММ, Курс "Алгоритмы и структуры данных"
+//
+// Вычислительные ядра векторов и матриц с выбором набора инструкций
+// во время выполнения
+//
+// Набор инструкций определяется один раз при первом обращении; переменная
+// окружения TMATRIX_ISA=scalar|sse4.2|avx2|avx512 понижает его (для тестов)
+//
+
+#ifndef __TKernels_H__
+#define __TKernels_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+using namespace std;
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TMATRIX_X86_DISPATCH 1
+#define TMATRIX_TARGET(isa) __attribute__((target(isa)))
+#define TMATRIX_INLINE inline __attribute__((always_inline))
+#else
+#define TMATRIX_TARGET(isa)
+#define TMATRIX_INLINE inline
+#endif
+
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define TMATRIX_RESTRICT __restrict
+#else
+#define TMATRIX_RESTRICT
+#endif
+
+enum TIsaLevel
+{
+  ISA_SCALAR,
+  ISA_SSE42,
+  ISA_AVX2,   // AVX2 + FMA
+  ISA_AVX512, // AVX-512F
+  ISA_LEVEL_COUNT
+};
+
+inline const char* isa_name(TIsaLevel isa) noexcept
+{
+  static const char* names[ISA_LEVEL_COUNT] = { "scalar", "sse4.2", "avx2", "avx512" };
+  return names[isa];
+}
+
+// наибольший набор инструкций, поддерживаемый процессором и ОС
+inline TIsaLevel detect_isa() noexcept
+{
+#ifdef TMATRIX_X86_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return ISA_AVX512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return ISA_AVX2;
+  if (__builtin_cpu_supports("sse4.2"))
+    return ISA_SSE42;
+#endif
+  return ISA_SCALAR;
+}
+
+namespace tmatrix_kernels
+{
+  // Обобщённые реализации ядер; компилируются заново для каждого набора
+  // инструкций при встраивании в обёртки с атрибутом target
+
+  template<typename T>
+  TMATRIX_INLINE void add_impl(T* TMATRIX_RESTRICT c, const T* TMATRIX_RESTRICT b, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      c[i] += b[i];
+  }
+
+  template<typename T>
+  TMATRIX_INLINE void sub_impl(T* TMATRIX_RESTRICT c, const T* TMATRIX_RESTRICT b, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      c[i] -= b[i];
+  }
+
+  template<typename T>
+  TMATRIX_INLINE void scale_impl(T* TMATRIX_RESTRICT c, T s, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      c[i] *= s;
+  }
+
+  // четыре независимые суммы: без переассоциации компилятор не векторизует
+  // последовательную редукцию
+  template<typename T>
+  TMATRIX_INLINE T dot_impl(const T* TMATRIX_RESTRICT a, const T* TMATRIX_RESTRICT b, size_t n)
+  {
+    T s0 = T(), s1 = T(), s2 = T(), s3 = T();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+      s0 += a[i] * b[i];
+      s1 += a[i + 1] * b[i + 1];
+      s2 += a[i + 2] * b[i + 2];
+      s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; i++)
+      s0 += a[i] * b[i];
+    return (s0 + s1) + (s2 + s3);
+  }
+
+  // y += a x
+  template<typename T>
+  TMATRIX_INLINE void axpy_impl(T* TMATRIX_RESTRICT y, const T* TMATRIX_RESTRICT x, T a, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      y[i] += a * x[i];
+  }
+
+  // y = a x + b y
+  template<typename T>
+  TMATRIX_INLINE void axpby_impl(T* TMATRIX_RESTRICT y, const T* TMATRIX_RESTRICT x, T a, T b, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      y[i] = a * x[i] + b * y[i];
+  }
+
+  // y += a x; возвращает y y, посчитанное в том же проходе
+  template<typename T>
+  TMATRIX_INLINE T axpy_dot_impl(T* TMATRIX_RESTRICT y, const T* TMATRIX_RESTRICT x, T a, size_t n)
+  {
+    T s0 = T(), s1 = T(), s2 = T(), s3 = T();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+      const T y0 = y[i] + a * x[i], y1 = y[i + 1] + a * x[i + 1];
+      const T y2 = y[i + 2] + a * x[i + 2], y3 = y[i + 3] + a * x[i + 3];
+      y[i] = y0;
+      y[i + 1] = y1;
+      y[i + 2] = y2;
+      y[i + 3] = y3;
+      s0 += y0 * y0;
+      s1 += y1 * y1;
+      s2 += y2 * y2;
+      s3 += y3 * y3;
+    }
+    for (; i < n; i++)
+    {
+      y[i] += a * x[i];
+      s0 += y[i] * y[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+  }
+
+  // y = alpha A x + beta y, A (m x n) задана указателями на строки;
+  // при beta = 0 прежнее содержимое y не читается
+  template<typename T>
+  TMATRIX_INLINE void matvec_impl(const T* const* a, const T* TMATRIX_RESTRICT x, T* TMATRIX_RESTRICT y,
+    size_t m, size_t n, T alpha, T beta)
+  {
+    for (size_t i = 0; i < m; i++)
+    {
+      const T s = alpha * dot_impl(a[i], x, n);
+      y[i] = beta == T() ? s : s + beta * y[i];
+    }
+  }
+
+  // C += alpha A B, A (m x k), B (k x n), C (m x n) заданы указателями на строки
+  // (порядок i-k-j: внутренний цикл идёт по строкам B и C)
+  template<typename T>
+  TMATRIX_INLINE void matmul_impl(const T* const* a, const T* const* b, T* const* c,
+    size_t m, size_t k, size_t n, T alpha)
+  {
+    for (size_t i = 0; i < m; i++)
+    {
+      T* TMATRIX_RESTRICT ci = c[i];
+      for (size_t l = 0; l < k; l++)
+      {
+        const T ail = alpha * a[i][l];
+        const T* TMATRIX_RESTRICT bl = b[l];
+        for (size_t j = 0; j < n; j++)
+          ci[j] += ail * bl[j];
+      }
+    }
+  }
+
+#define TMATRIX_KERNEL_SET(name, attr) \
+  struct name \
+  { \
+    template<typename T> attr static void add(T* c, const T* b, size_t n) { add_impl(c, b, n); } \
+    template<typename T> attr static void sub(T* c, const T* b, size_t n) { sub_impl(c, b, n); } \
+    template<typename T> attr static void scale(T* c, T s, size_t n) { scale_impl(c, s, n); } \
+    template<typename T> attr static T dot(const T* a, const T* b, size_t n) { return dot_impl(a, b, n); } \
+    template<typename T> attr static void axpy(T* y, const T* x, T a, size_t n) { axpy_impl(y, x, a, n); } \
+    template<typename T> attr static void axpby(T* y, const T* x, T a, T b, size_t n) { axpby_impl(y, x, a, b, n); } \
+    template<typename T> attr static T axpy_dot(T* y, const T* x, T a, size_t n) { return axpy_dot_impl(y, x, a, n); } \
+    template<typename T> attr static void matvec(const T* const* a, const T* x, T* y, size_t m, size_t n, \
+      T alpha, T beta) \
+    { matvec_impl(a, x, y, m, n, alpha, beta); } \
+    template<typename T> attr static void matmul(const T* const* a, const T* const* b, T* const* c, \
+      size_t m, size_t k, size_t n, T alpha) \
+    { matmul_impl(a, b, c, m, k, n, alpha); } \
+  };
+
+  TMATRIX_KERNEL_SET(TScalarKernels, )
+#ifdef TMATRIX_X86_DISPATCH
+  TMATRIX_KERNEL_SET(TSse42Kernels, TMATRIX_TARGET("sse4.2"))
+  TMATRIX_KERNEL_SET(TAvx2Kernels, TMATRIX_TARGET("avx2,fma"))
+  TMATRIX_KERNEL_SET(TAvx512Kernels, TMATRIX_TARGET("avx512f,avx2,fma"))
+#endif
+#undef TMATRIX_KERNEL_SET
+
+  inline TIsaLevel env_isa(TIsaLevel detected) noexcept
+  {
+    const char* env = getenv("TMATRIX_ISA");
+    if (env == nullptr)
+      return detected;
+    for (int k = 0; k < ISA_LEVEL_COUNT; k++)
+      if (strcmp(env, isa_name(TIsaLevel(k))) == 0)
+        return TIsaLevel(k) < detected ? TIsaLevel(k) : detected;
+    return detected;
+  }
+
+  inline atomic<int>& active_isa() noexcept
+  {
+    static atomic<int> isa(env_isa(detect_isa()));
+    return isa;
+  }
+}
+
+// Таблица ядер для типа элементов T
+template<typename T>
+struct TKernelTable
+{
+  void (*add)(T* c, const T* b, size_t n);      // c += b
+  void (*sub)(T* c, const T* b, size_t n);      // c -= b
+  void (*scale)(T* c, T s, size_t n);           // c *= s
+  T (*dot)(const T* a, const T* b, size_t n);
+  void (*axpy)(T* y, const T* x, T a, size_t n);          // y += a x
+  void (*axpby)(T* y, const T* x, T a, T b, size_t n);    // y = a x + b y
+  T (*axpy_dot)(T* y, const T* x, T a, size_t n);         // y += a x, возвращает y y
+  void (*matvec)(const T* const* a, const T* x, T* y, size_t m, size_t n, T alpha, T beta); // y = alpha A x + beta y
+  void (*matmul)(const T* const* a, const T* const* b, T* const* c, size_t m, size_t k, size_t n, T alpha); // C += alpha A B
+
+  template<typename K>
+  static TKernelTable make() noexcept
+  {
+    return { &K::template add<T>, &K::template sub<T>, &K::template scale<T>,
+      &K::template dot<T>, &K::template axpy<T>, &K::template axpby<T>, &K::template axpy_dot<T>,
+      &K::template matvec<T>, &K::template matmul<T> };
+  }
+};
+
+// текущий набор инструкций
+inline TIsaLevel current_isa() noexcept
+{
+  return TIsaLevel(tmatrix_kernels::active_isa().load(memory_order_relaxed));
+}
+
+// принудительный выбор набора инструкций (не выше поддерживаемого); возвращает выбранный
+inline TIsaLevel select_isa(TIsaLevel isa) noexcept
+{
+  const TIsaLevel detected = detect_isa();
+  const TIsaLevel chosen = isa < detected ? isa : detected;
+  tmatrix_kernels::active_isa().store(chosen, memory_order_relaxed);
+  return chosen;
+}
+
+namespace tmatrix_kernels
+{
+  template<typename T, typename K>
+  TKernelTable<T> make_table() noexcept
+  {
+    if constexpr (is_arithmetic<T>::value)
+      return TKernelTable<T>::template make<K>();
+    else
+      return TKernelTable<T>::template make<TScalarKernels>();
+  }
+}
+
+// Ядра для T; специализированные варианты - только для встроенных
+// арифметических типов, для остальных T всегда скалярные
+template<typename T>
+const TKernelTable<T>& kernels() noexcept
+{
+  using namespace tmatrix_kernels;
+  static const TKernelTable<T> tables[ISA_LEVEL_COUNT] = {
+    make_table<T, TScalarKernels>(),
+#ifdef TMATRIX_X86_DISPATCH
+    make_table<T, TSse42Kernels>(),
+    make_table<T, TAvx2Kernels>(),
+    make_table<T, TAvx512Kernels>(),
+#else
+    make_table<T, TScalarKernels>(),
+    make_table<T, TScalarKernels>(),
+    make_table<T, TScalarKernels>(),
+#endif
+  };
+  return tables[current_isa()];
+}
+
+#endif
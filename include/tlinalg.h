@@ -0,0 +1,732 @@
+// ННГУ, ИИТММ, Курс "Алгоритмы и структуры данных"
+//
+// Разложения плотных матриц, решение систем линейных уравнений,
+// возведение матрицы в степень
+//
+
+#ifndef __TLinalg_H__
+#define __TLinalg_H__
+
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "tblas.h"
+#include "tgemm.h"
+#include "tmatrix.h"
+#include "tpermutation.h"
+
+using namespace std;
+
+enum TTriangle { TRI_LOWER, TRI_UPPER };
+enum TTranspose { NO_TRANS, TRANS };
+enum TDiagonal { NON_UNIT_DIAG, UNIT_DIAG };
+
+namespace tmatrix_detail
+{
+  // одна полоса столбцов B шириной nrhs: блочная подстановка, вне диагональных
+  // блоков - умножение матриц
+  template<typename T, typename RA>
+  void trsm_panel(const RA& a, T* const* b, size_t n, size_t nrhs, bool lower, bool trans,
+    bool unit, size_t nb, const TGemmParams& gp)
+  {
+    auto elem = [&a, trans](size_t i, size_t j) { return trans ? a[j][i] : a[i][j]; };
+    const TKernelTable<T>& kern = kernels<T>();
+    vector<T> panel;
+    vector<const T*> p_rows, b_src;
+    auto solve_block = [&](size_t k0, size_t k1) {
+      for (size_t t = 0; t < k1 - k0; t++)
+      {
+        const size_t i = lower ? k0 + t : k1 - 1 - t;
+        T* bi = b[i];
+        for (size_t r = lower ? k0 : i + 1; r < (lower ? i : k1); r++)
+          kern.axpy(bi, b[r], -elem(i, r), nrhs);
+        if (!unit)
+        {
+          const T d = elem(i, i);
+          for (size_t c = 0; c < nrhs; c++)
+            bi[c] /= d;
+        }
+      }
+    };
+    // B[r0, r1) -= A[r0, r1) x [k0, k1) B[k0, k1)
+    auto update = [&](size_t r0, size_t r1, size_t k0, size_t k1) {
+      const size_t m = r1 - r0, w = k1 - k0;
+      if (m == 0)
+        return;
+      p_rows.resize(m);
+      b_src.resize(w);
+      if (trans)
+      {
+        // блок A^T собирается построчно
+        panel.resize(m * w);
+        for (size_t i = 0; i < m; i++)
+        {
+          for (size_t c = 0; c < w; c++)
+            panel[i * w + c] = elem(r0 + i, k0 + c);
+          p_rows[i] = &panel[i * w];
+        }
+      }
+      else
+        for (size_t i = 0; i < m; i++)
+          p_rows[i] = row_at(a, r0 + i) + k0;
+      for (size_t c = 0; c < w; c++)
+        b_src[c] = b[k0 + c];
+      gemm_rows(T(-1), p_rows.data(), b_src.data(), T(1), b + r0, m, w, nrhs, gp);
+    };
+    if (lower)
+      for (size_t k0 = 0; k0 < n; k0 += nb)
+      {
+        const size_t k1 = min(k0 + nb, n);
+        solve_block(k0, k1);
+        update(k1, n, k0, k1);
+      }
+    else
+      for (size_t k1 = n; k1 > 0;)
+      {
+        const size_t k0 = k1 > nb ? k1 - nb : 0;
+        solve_block(k0, k1);
+        update(0, k0, k0, k1);
+        k1 = k0;
+      }
+  }
+}
+
+// Треугольная система op(A) X = B на месте для nrhs правых частей:
+// A (n x n) и B (n x nrhs) - массивы указателей на строки или матрицы, как в gemm_rows;
+// полосы столбцов B решаются параллельно, каждая - блоками по nb строк
+template<typename RA, typename RB>
+void trsm_rows(const RA& a, RB&& b, size_t n, size_t nrhs, TTriangle uplo,
+  TTranspose trans = NO_TRANS, TDiagonal diag = NON_UNIT_DIAG, size_t nb = 64)
+{
+  using T = tmatrix_detail::row_elem_t<const RA>;
+  const bool lower = (uplo == TRI_LOWER) != (trans == TRANS);
+  nb = max<size_t>(nb, 1);
+  TGemmParams seq = gemm_params(); // параллельность - по полосам столбцов
+  seq.par_min_gemm = size_t(1) << 30;
+  parallel_for(0, nrhs, 32, [&](size_t c0, size_t c1) {
+    vector<T*> cols(n);
+    for (size_t i = 0; i < n; i++)
+      cols[i] = tmatrix_detail::row_at(b, i) + c0;
+    tmatrix_detail::trsm_panel(a, cols.data(), n, c1 - c0, lower, trans == TRANS, diag == UNIT_DIAG, nb, seq);
+  });
+}
+
+// op(A) X = B, столбцы B - правые части; результат записывается в B
+template<typename T>
+void trsm(const TDynamicMatrix<T>& a, TDynamicMatrix<T>& b, TTriangle uplo,
+  TTranspose trans = NO_TRANS, TDiagonal diag = NON_UNIT_DIAG)
+{
+  if (a.size() != b.size())
+    throw length_error("Right-hand side size should match the matrix size");
+  trsm_rows(a, b, a.size(), b.size(), uplo, trans, diag);
+}
+
+// op(A) x = b на месте; без транспонирования - скалярные произведения строк,
+// с транспонированием - вычитание строк A из x
+template<typename T>
+void trsv(const TDynamicMatrix<T>& a, TDynamicVector<T>& x, TTriangle uplo,
+  TTranspose trans = NO_TRANS, TDiagonal diag = NON_UNIT_DIAG)
+{
+  const size_t n = a.size();
+  if (x.size() != n)
+    throw length_error("Right-hand side size should match the matrix size");
+  const TKernelTable<T>& kern = kernels<T>();
+  T* px = &x[0];
+  if (trans == NO_TRANS)
+    for (size_t t = 0; t < n; t++)
+    {
+      const size_t i = uplo == TRI_LOWER ? t : n - 1 - t;
+      const T* ai = &a[i][0];
+      const T s = uplo == TRI_LOWER ? kern.dot(ai, px, i) : kern.dot(ai + i + 1, px + i + 1, n - i - 1);
+      px[i] -= s;
+      if (diag == NON_UNIT_DIAG)
+        px[i] /= ai[i];
+    }
+  else
+    for (size_t t = 0; t < n; t++)
+    {
+      const size_t i = uplo == TRI_LOWER ? n - 1 - t : t;
+      const T* ai = &a[i][0];
+      if (diag == NON_UNIT_DIAG)
+        px[i] /= ai[i];
+      const T v = px[i];
+      const size_t b = uplo == TRI_LOWER ? 0 : i + 1, e = uplo == TRI_LOWER ? i : n;
+      kern.axpy(px + b, ai + b, -v, e - b);
+    }
+}
+
+// LU-разложение с выбором главного элемента по столбцу -
+// P A = L U, L - нижняя с единичной диагональю, U - верхняя;
+// блочный правосторонний алгоритм: панель из nb столбцов раскладывается
+// построчно, остаток матрицы обновляется умножением матриц (tgemm.h);
+// перестановки строк не перемещают данные (TDynamicMatrix::swap_rows)
+template<typename T>
+class TLU
+{
+  static_assert(is_floating_point<T>::value, "TLU requires a floating point element type");
+
+  TDynamicMatrix<T> lu; // L ниже диагонали, U - на диагонали и выше
+  TPermutation perm;    // P: на месте i стоит исходная строка perm[i]
+  bool singular;
+
+  void factor(size_t nb)
+  {
+    const size_t n = lu.size();
+    nb = max<size_t>(nb, 1);
+    vector<const T*> l_rows, u_rows;
+    vector<T*> c_rows;
+    for (size_t k0 = 0; k0 < n; k0 += nb)
+    {
+      const size_t k1 = min(k0 + nb, n);
+      // панель: столбцы [k0, k1), все строки ниже k0
+      for (size_t j = k0; j < k1; j++)
+      {
+        size_t p = j;
+        for (size_t i = j + 1; i < n; i++)
+          if (abs(lu[i][j]) > abs(lu[p][j]))
+            p = i;
+        lu.swap_rows(j, p);
+        perm.swap(j, p);
+        const T d = lu[j][j];
+        if (d == T())
+        {
+          singular = true;
+          continue;
+        }
+        const T* uj = &lu[j][0];
+        for (size_t i = j + 1; i < n; i++)
+        {
+          T* ai = &lu[i][0];
+          const T l = ai[j] /= d;
+          for (size_t c = j + 1; c < k1; c++)
+            ai[c] -= l * uj[c];
+        }
+      }
+      if (k1 == n)
+        break;
+
+      // U12 = L11^-1 A12
+      for (size_t i = k0 + 1; i < k1; i++)
+      {
+        T* ai = &lu[i][0];
+        for (size_t r = k0; r < i; r++)
+        {
+          const T l = ai[r];
+          const T* ur = &lu[r][0];
+          for (size_t c = k1; c < n; c++)
+            ai[c] -= l * ur[c];
+        }
+      }
+
+      // A22 -= L21 U12
+      const size_t m = n - k1, w = k1 - k0;
+      l_rows.resize(m);
+      c_rows.resize(m);
+      u_rows.resize(w);
+      for (size_t i = 0; i < m; i++)
+      {
+        l_rows[i] = &lu[k1 + i][k0];
+        c_rows[i] = &lu[k1 + i][k1];
+      }
+      for (size_t r = 0; r < w; r++)
+        u_rows[r] = &lu[k0 + r][k1];
+      gemm_rows(T(-1), l_rows.data(), u_rows.data(), T(1), c_rows.data(), m, w, m);
+    }
+  }
+
+  void check_solvable(size_t n) const
+  {
+    if (n != lu.size())
+      throw length_error("Right-hand side size should match the matrix size");
+    if (singular)
+      throw runtime_error("Matrix is singular");
+  }
+public:
+  explicit TLU(const TDynamicMatrix<T>& a, size_t nb = 64) : lu(a), perm(a.size()), singular(false)
+  {
+    factor(nb);
+  }
+  explicit TLU(TDynamicMatrix<T>&& a, size_t nb = 64) : lu(std::move(a)), perm(lu.size()), singular(false)
+  {
+    factor(nb);
+  }
+
+  size_t size() const noexcept { return lu.size(); }
+  bool is_singular() const noexcept { return singular; }
+  const TDynamicMatrix<T>& factors() const noexcept { return lu; }
+  const TPermutation& permutation() const noexcept { return perm; }
+
+  T det() const
+  {
+    T d = T(perm.sign());
+    for (size_t i = 0; i < lu.size(); i++)
+      d *= lu[i][i];
+    return d;
+  }
+
+  // решение для nrhs правых частей на месте: b[i] - строка i длины nrhs
+  void solve_rows(T* const* b, size_t nrhs) const
+  {
+    check_solvable(lu.size());
+    perm.apply_rows(b, nrhs);
+    trsm_rows(lu, b, lu.size(), nrhs, TRI_LOWER, NO_TRANS, UNIT_DIAG);
+    trsm_rows(lu, b, lu.size(), nrhs, TRI_UPPER);
+  }
+
+  TDynamicVector<T> solve(const TDynamicVector<T>& b) const
+  {
+    check_solvable(b.size());
+    TDynamicVector<T> x(b);
+    perm.apply(x);
+    trsv(lu, x, TRI_LOWER, NO_TRANS, UNIT_DIAG);
+    trsv(lu, x, TRI_UPPER);
+    return x;
+  }
+  // столбцы B - правые части
+  TDynamicMatrix<T> solve(const TDynamicMatrix<T>& b) const
+  {
+    check_solvable(b.size());
+    TDynamicMatrix<T> x(b);
+    perm.apply(x);
+    trsm_rows(lu, x, lu.size(), x.size(), TRI_LOWER, NO_TRANS, UNIT_DIAG);
+    trsm_rows(lu, x, lu.size(), x.size(), TRI_UPPER);
+    return x;
+  }
+};
+
+// Разложение Холецкого симметричной положительно определённой матрицы -
+// A = L L^T; читается только нижний треугольник A (с диагональю).
+// Блочный правосторонний алгоритм: после разложения диагонального блока
+// строки панели L21 вычисляются параллельно, остаток A22 -= L21 L21^T
+// обновляется умножением матриц только в нижнем треугольнике
+template<typename T>
+class TCholesky
+{
+  static_assert(is_floating_point<T>::value, "TCholesky requires a floating point element type");
+
+  TDynamicMatrix<T> l; // L в нижнем треугольнике, выше диагонали - нули
+
+  static void not_positive_definite()
+  {
+    throw runtime_error("Matrix is not positive definite");
+  }
+
+  void decompose(size_t nb)
+  {
+    const size_t n = l.size();
+    nb = max<size_t>(nb, 1);
+    TGemmParams seq = gemm_params(); // параллельность - на уровне блоков строк
+    seq.par_min_gemm = size_t(1) << 30;
+    vector<T> lt;
+    vector<const T*> l_rows, lt_rows;
+    vector<T*> c_rows;
+    for (size_t k0 = 0; k0 < n; k0 += nb)
+    {
+      const size_t k1 = min(k0 + nb, n);
+      // диагональный блок
+      for (size_t j = k0; j < k1; j++)
+      {
+        T* lj = &l[j][0];
+        if (!(lj[j] > T()))
+          not_positive_definite();
+        const T d = lj[j] = sqrt(lj[j]);
+        for (size_t i = j + 1; i < k1; i++)
+        {
+          T* li = &l[i][0];
+          const T v = li[j] /= d;
+          for (size_t c = j + 1; c <= i; c++)
+            li[c] -= v * l[c][j];
+        }
+      }
+      if (k1 == n)
+        break;
+
+      // L21 = A21 L11^-T, строки независимы
+      parallel_for(k1, n, 32, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; i++)
+        {
+          T* li = &l[i][0];
+          for (size_t j = k0; j < k1; j++)
+          {
+            const T* lj = &l[j][0];
+            T s = li[j];
+            for (size_t p = k0; p < j; p++)
+              s -= li[p] * lj[p];
+            li[j] = s / lj[j];
+          }
+        }
+      });
+
+      // A22 -= L21 L21^T в нижнем треугольнике; блоки строк попарно
+      // (короткий с длинным), чтобы уравнять работу потоков
+      const size_t m = n - k1, w = k1 - k0;
+      lt.resize(w * m);
+      l_rows.resize(m);
+      c_rows.resize(m);
+      lt_rows.resize(w);
+      for (size_t i = 0; i < m; i++)
+      {
+        const T* src = &l[k1 + i][k0];
+        for (size_t c = 0; c < w; c++)
+          lt[c * m + i] = src[c];
+        l_rows[i] = src;
+        c_rows[i] = &l[k1 + i][k1];
+      }
+      for (size_t c = 0; c < w; c++)
+        lt_rows[c] = &lt[c * m];
+      const size_t nblk = (m + nb - 1) / nb;
+      auto update = [&](size_t blk) {
+        const size_t r0 = blk * nb, r1 = min(r0 + nb, m);
+        gemm_rows(T(-1), &l_rows[r0], lt_rows.data(), T(1), &c_rows[r0], r1 - r0, w, r1, seq);
+      };
+      parallel_for(0, (nblk + 1) / 2, 1, [&](size_t b, size_t e) {
+        for (size_t k = b; k < e; k++)
+        {
+          update(k);
+          if (nblk - 1 - k != k)
+            update(nblk - 1 - k);
+        }
+      });
+    }
+    for (size_t i = 0; i < n; i++)
+      fill(&l[i][0] + i + 1, &l[i][0] + n, T());
+  }
+public:
+  explicit TCholesky(const TDynamicMatrix<T>& a, size_t nb = 64) : l(a)
+  {
+    decompose(nb);
+  }
+  explicit TCholesky(TDynamicMatrix<T>&& a, size_t nb = 64) : l(std::move(a))
+  {
+    decompose(nb);
+  }
+
+  size_t size() const noexcept { return l.size(); }
+  const TDynamicMatrix<T>& factors() const noexcept { return l; }
+
+  // ln det A = 2 sum ln L[i][i]
+  T logdet() const
+  {
+    T s = T();
+    for (size_t i = 0; i < l.size(); i++)
+      s += log(l[i][i]);
+    return 2 * s;
+  }
+
+  // решение для nrhs правых частей на месте: b[i] - строка i длины nrhs
+  void solve_rows(T* const* b, size_t nrhs) const
+  {
+    trsm_rows(l, b, l.size(), nrhs, TRI_LOWER);
+    trsm_rows(l, b, l.size(), nrhs, TRI_LOWER, TRANS);
+  }
+
+  TDynamicVector<T> solve(const TDynamicVector<T>& b) const
+  {
+    if (b.size() != l.size())
+      throw length_error("Right-hand side size should match the matrix size");
+    TDynamicVector<T> x(b);
+    trsv(l, x, TRI_LOWER);
+    trsv(l, x, TRI_LOWER, TRANS);
+    return x;
+  }
+  // столбцы B - правые части
+  TDynamicMatrix<T> solve(const TDynamicMatrix<T>& b) const
+  {
+    if (b.size() != l.size())
+      throw length_error("Right-hand side size should match the matrix size");
+    TDynamicMatrix<T> x(b);
+    trsm_rows(l, x, l.size(), x.size(), TRI_LOWER);
+    trsm_rows(l, x, l.size(), x.size(), TRI_LOWER, TRANS);
+    return x;
+  }
+};
+
+// QR-разложение отражениями Хаусхолдера -
+// A = Q R для A из m строк длины n, m >= n; Q = H_1 ... H_n, H_j = I - tau_j v_j v_j^T.
+// Блочный алгоритм: отражения панели из nb столбцов собираются в компактную
+// форму WY (H_1 ... H_w = I - V T V^T) и применяются к остатку матрицы
+// двумя умножениями матриц
+template<typename T>
+class TQR
+{
+  static_assert(is_floating_point<T>::value, "TQR requires a floating point element type");
+
+  TDynamicVector<TDynamicVector<T>> qr; // R на диагонали и выше, v_j - ниже (v_j[j] = 1)
+  TDynamicVector<T> tau;
+  size_t m, n;
+
+  // отражение для столбца j панели [j, k1) и его применение к столбцам (j, k1)
+  void reflect_column(size_t j, size_t k1, vector<T>& s)
+  {
+    T norm2 = T();
+    for (size_t i = j + 1; i < m; i++)
+      norm2 += qr[i][j] * qr[i][j];
+    const T alpha = qr[j][j];
+    if (norm2 == T())
+    {
+      tau[j] = T();
+      return;
+    }
+    const T beta = alpha >= T() ? -sqrt(alpha * alpha + norm2) : sqrt(alpha * alpha + norm2);
+    tau[j] = (beta - alpha) / beta;
+    const T scale = T(1) / (alpha - beta);
+    for (size_t i = j + 1; i < m; i++)
+      qr[i][j] *= scale;
+    qr[j][j] = beta;
+
+    // A[j:m, j+1:k1] -= tau v (v^T A)
+    const size_t w = k1 - j - 1;
+    if (w == 0)
+      return;
+    s.assign(qr[j].size(), T());
+    for (size_t c = 0; c < w; c++)
+      s[c] = qr[j][j + 1 + c];
+    for (size_t i = j + 1; i < m; i++)
+    {
+      const T v = qr[i][j];
+      const T* ai = &qr[i][j + 1];
+      for (size_t c = 0; c < w; c++)
+        s[c] += v * ai[c];
+    }
+    for (size_t c = 0; c < w; c++)
+      qr[j][j + 1 + c] -= tau[j] * s[c];
+    for (size_t i = j + 1; i < m; i++)
+    {
+      const T f = tau[j] * qr[i][j];
+      T* ai = &qr[i][j + 1];
+      for (size_t c = 0; c < w; c++)
+        ai[c] -= f * s[c];
+    }
+  }
+
+  void decompose(size_t nb)
+  {
+    nb = max<size_t>(nb, 1);
+    vector<T> s, vt, vr, tm, wk;
+    vector<const T*> vt_rows, v_rows;
+    vector<T*> a_rows, wk_rows;
+    for (size_t k0 = 0; k0 < n; k0 += nb)
+    {
+      const size_t k1 = min(k0 + nb, n), w = k1 - k0, mm = m - k0;
+      for (size_t j = k0; j < k1; j++)
+        reflect_column(j, k1, s);
+      if (k1 == n)
+        break;
+
+      // V (mm x w) с единицами на диагонали и нулями выше; V^T и V по строкам для умножений
+      vt.assign(w * mm, T());
+      vr.assign(mm * w, T());
+      for (size_t i = 0; i < mm; i++)
+        for (size_t c = 0; c < w; c++)
+        {
+          const T v = i == c ? T(1) : i > c ? qr[k0 + i][k0 + c] : T();
+          vt[c * mm + i] = v;
+          vr[i * w + c] = v;
+        }
+      // T (w x w), верхняя треугольная: T[c][c] = tau_c,
+      // T[0:c, c] = -tau_c T[0:c, 0:c] (V[:, 0:c]^T v_c)
+      tm.assign(w * w, T());
+      for (size_t c = 0; c < w; c++)
+      {
+        const T t = tau[k0 + c];
+        tm[c * w + c] = t;
+        s.assign(c, T());
+        for (size_t r = 0; r < c; r++)
+          for (size_t i = c; i < mm; i++)
+            s[r] += vt[r * mm + i] * vt[c * mm + i];
+        for (size_t r = 0; r < c; r++)
+        {
+          T acc = T();
+          for (size_t q = r; q < c; q++)
+            acc += tm[r * w + q] * s[q];
+          tm[r * w + c] = -t * acc;
+        }
+      }
+
+      // A2 -= V T^T (V^T A2), A2 = A[k0:m, k1:n]
+      const size_t nc = n - k1;
+      wk.resize(w * nc);
+      vt_rows.resize(w);
+      wk_rows.resize(w);
+      a_rows.resize(mm);
+      v_rows.resize(mm);
+      for (size_t c = 0; c < w; c++)
+      {
+        vt_rows[c] = &vt[c * mm];
+        wk_rows[c] = &wk[c * nc];
+      }
+      for (size_t i = 0; i < mm; i++)
+      {
+        a_rows[i] = &qr[k0 + i][k1];
+        v_rows[i] = &vr[i * w];
+      }
+      gemm_rows(T(1), vt_rows.data(), a_rows.data(), T(), wk_rows.data(), w, mm, nc);
+      // W = T^T W: строки снизу вверх, T^T - нижняя треугольная
+      for (size_t r = w; r-- > 0;)
+      {
+        T* wr = &wk[r * nc];
+        const T d = tm[r * w + r];
+        for (size_t c = 0; c < nc; c++)
+          wr[c] *= d;
+        for (size_t q = 0; q < r; q++)
+        {
+          const T t = tm[q * w + r];
+          const T* wq = &wk[q * nc];
+          for (size_t c = 0; c < nc; c++)
+            wr[c] += t * wq[c];
+        }
+      }
+      gemm_rows(T(-1), v_rows.data(), wk_rows.data(), T(1), a_rows.data(), mm, w, nc);
+    }
+  }
+
+  void init_rows(size_t rows, size_t cols)
+  {
+    if (rows < cols)
+      throw invalid_argument("QR requires at least as many rows as columns");
+    m = rows;
+    n = cols;
+  }
+public:
+  // a - m строк одинаковой длины n
+  explicit TQR(const TDynamicVector<TDynamicVector<T>>& a, size_t nb = 32) : qr(a), tau(a[0].size())
+  {
+    for (size_t i = 0; i < a.size(); i++)
+      if (a[i].size() != a[0].size())
+        throw length_error("All rows should have the same length");
+    init_rows(a.size(), a[0].size());
+    decompose(nb);
+  }
+  explicit TQR(const TDynamicMatrix<T>& a, size_t nb = 32) : qr(a.size()), tau(a.size())
+  {
+    for (size_t i = 0; i < a.size(); i++)
+      qr[i] = a[i];
+    init_rows(a.size(), a.size());
+    decompose(nb);
+  }
+
+  size_t rows() const noexcept { return m; }
+  size_t cols() const noexcept { return n; }
+  const TDynamicVector<TDynamicVector<T>>& factors() const noexcept { return qr; }
+  const TDynamicVector<T>& reflectors() const noexcept { return tau; }
+
+  // верхняя треугольная R (n x n)
+  TDynamicMatrix<T> r() const
+  {
+    TDynamicMatrix<T> res(n);
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = i; j < n; j++)
+        res[i][j] = qr[i][j];
+    return res;
+  }
+
+  // b = Q^T b, b длины m
+  void apply_qt(TDynamicVector<T>& b) const
+  {
+    if (b.size() != m)
+      throw length_error("Vector size should match the number of rows");
+    for (size_t j = 0; j < n; j++)
+    {
+      if (tau[j] == T())
+        continue;
+      T s = b[j];
+      for (size_t i = j + 1; i < m; i++)
+        s += qr[i][j] * b[i];
+      s *= tau[j];
+      b[j] -= s;
+      for (size_t i = j + 1; i < m; i++)
+        b[i] -= s * qr[i][j];
+    }
+  }
+
+  // решение задачи наименьших квадратов min ||A x - b||, b длины m, x длины n
+  TDynamicVector<T> solve(const TDynamicVector<T>& b) const
+  {
+    TDynamicVector<T> y(b);
+    apply_qt(y);
+    vector<const T*> r_rows(n);
+    vector<T*> x_rows(n);
+    TDynamicVector<T> x(n);
+    for (size_t i = 0; i < n; i++)
+    {
+      if (qr[i][i] == T())
+        throw runtime_error("Matrix is rank deficient");
+      r_rows[i] = &qr[i][0];
+      x[i] = y[i];
+      x_rows[i] = &x[i];
+    }
+    trsm_rows(r_rows.data(), x_rows.data(), n, 1, TRI_UPPER);
+    return x;
+  }
+};
+
+template<typename T>
+TDynamicVector<T> lstsq(const TDynamicVector<TDynamicVector<T>>& a, const TDynamicVector<T>& b)
+{
+  return TQR<T>(a).solve(b);
+}
+
+// A^k бинарным возведением в степень: O(log k) умножений матриц (gemm_rows)
+// на трёх буферах, которые меняются ролями без копирования. Шаги не выделяют
+// память, пока умножение выполняется последовательно (n^3 < par_min_gemm^3);
+// выше порога каждое умножение ставит задачи в пул потоков (tparallel.h),
+// а постановка задачи выделяет память
+template<typename T>
+TDynamicMatrix<T> pow(const TDynamicMatrix<T>& a, unsigned long long k)
+{
+  const size_t n = a.size();
+  TDynamicMatrix<T> res(n);
+  if (k == 0)
+  {
+    for (size_t i = 0; i < n; i++)
+      res[i][i] = T(1);
+    return res;
+  }
+  TDynamicMatrix<T> base(a), tmp(n);
+  // tmp = x y, затем tmp и x меняются ролями
+  auto mul_into = [&](TDynamicMatrix<T>& x, const TDynamicMatrix<T>& y) {
+    gemm_rows(T(1), x, y, T(), tmp, n, n, n);
+    swap(x, tmp);
+  };
+  bool res_is_identity = true;
+  for (;;)
+  {
+    if (k & 1)
+    {
+      if (res_is_identity)
+      {
+        res = base;
+        res_is_identity = false;
+      }
+      else
+        mul_into(res, base);
+    }
+    k >>= 1;
+    if (k == 0)
+      break;
+    mul_into(base, base);
+  }
+  return res;
+}
+
+template<typename T>
+T det(const TDynamicMatrix<T>& a)
+{
+  return TLU<T>(a).det();
+}
+
+template<typename T>
+TDynamicVector<T> solve(const TDynamicMatrix<T>& a, const TDynamicVector<T>& b)
+{
+  return TLU<T>(a).solve(b);
+}
+
+template<typename T>
+TDynamicMatrix<T> solve(const TDynamicMatrix<T>& a, const TDynamicMatrix<T>& b)
+{
+  return TLU<T>(a).solve(b);
+}
+
+#endif
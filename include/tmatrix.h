@@ -8,13 +8,179 @@
 #define __TDynamicMatrix_H__
 
 #include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <locale>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "tgemm.h"
+#include "tkernels.h"
+#include "tprofile.h"
 
 using namespace std;
 
 const int MAX_VECTOR_SIZE = 100000000;
 const int MAX_MATRIX_SIZE = 10000;
 
-// Динамический вектор - 
+// Быстрый текстовый ввод/вывод чисел через from_chars/to_chars
+// (без локалей и виртуальных вызовов iostream на каждый элемент)
+namespace tmatrix_detail
+{
+  // типы, для которых применим быстрый путь; для остальных T - operator>>/<<
+  template<typename T>
+  constexpr bool is_fast_io_v = std::is_floating_point<T>::value ||
+    (std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+     !std::is_same<T, char>::value && !std::is_same<T, signed char>::value &&
+     !std::is_same<T, unsigned char>::value && !std::is_same<T, wchar_t>::value &&
+     !std::is_same<T, char16_t>::value && !std::is_same<T, char32_t>::value);
+
+  inline bool is_space(char c) noexcept
+  {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+  }
+
+  // разбор одного числа из [first, last); указатель за числом или nullptr
+  template<typename T>
+  const char* parse_value(const char* first, const char* last, T& val) noexcept
+  {
+    if (last - first > 1 && *first == '+' && first[1] != '-')
+      ++first; // from_chars не принимает явный '+'
+    // как operator>>: "-x" для беззнакового T - значение x по модулю 2^N со знаком минус
+    bool negate = false;
+    if constexpr (std::is_unsigned<T>::value)
+      if (last - first > 1 && *first == '-' && first[1] != '+')
+      {
+        negate = true;
+        ++first;
+      }
+    from_chars_result r;
+    if constexpr (std::is_floating_point<T>::value)
+      r = from_chars(first, last, val);
+    else
+      r = from_chars(first, last, val, 10);
+    if (r.ec != errc())
+      return nullptr;
+    if (negate)
+      val = T(T(0) - val);
+    return r.ptr;
+  }
+
+  // разбор n чисел, разделённых пробельными символами, из буфера в памяти
+  template<typename T>
+  const char* parse_values(const char* first, const char* last, T* out, size_t n) noexcept
+  {
+    for (size_t i = 0; i < n; i++)
+    {
+      while (first != last && is_space(*first))
+        ++first;
+      first = parse_value(first, last, out[i]);
+      if (first == nullptr)
+        return nullptr;
+    }
+    return first;
+  }
+
+  // быстрый путь допустим только для формата по умолчанию
+  inline bool has_default_format(const ios_base& s)
+  {
+    const ios_base::fmtflags custom = ios_base::floatfield | ios_base::showpos |
+      ios_base::showpoint | ios_base::showbase | ios_base::uppercase;
+    return (s.flags() & custom) == 0 &&
+      (s.flags() & ios_base::basefield) == ios_base::dec &&
+      s.width() == 0 && s.getloc() == locale::classic();
+  }
+
+  // для вывода вещественных чисел нужна ещё и точность по умолчанию:
+  // при заданной setprecision вывод совпадает с operator<< для T
+  template<typename T>
+  bool has_default_output_format(const ios_base& s)
+  {
+    return has_default_format(s) && (!std::is_floating_point<T>::value || s.precision() == 6);
+  }
+
+  // чтение n чисел из потока: лексемы выбираются прямо из буфера streambuf
+  template<typename T>
+  void read_values(istream& istr, T* out, size_t n)
+  {
+    istream::sentry se(istr);
+    if (!se)
+      return;
+    streambuf* sb = istr.rdbuf();
+    const int eof = char_traits<char>::eof();
+    char tok[128];
+    ios_base::iostate state = ios_base::goodbit;
+    int c = sb->sgetc();
+    for (size_t i = 0; i < n; i++)
+    {
+      while (c != eof && is_space(char(c)))
+        c = sb->snextc();
+      size_t len = 0;
+      while (c != eof && !is_space(char(c)) && len < sizeof(tok))
+      {
+        tok[len++] = char(c);
+        c = sb->snextc();
+      }
+      if (c == eof)
+        state |= ios_base::eofbit;
+      // лексема длиннее буфера не обрезается, а считается ошибкой
+      const bool too_long = len == sizeof(tok) && c != eof && !is_space(char(c));
+      if (len == 0 || too_long || parse_value(tok, tok + len, out[i]) != tok + len)
+      {
+        state |= ios_base::failbit;
+        break;
+      }
+    }
+    istr.setstate(state);
+  }
+
+  // буферизованная запись: числа форматируются в локальный буфер
+  // (кратчайшее точное представление) и сбрасываются в поток блоками
+  class TTextWriter
+  {
+    ostream& ostr;
+    size_t len;
+    char buf[1 << 14];
+  public:
+    explicit TTextWriter(ostream& os) : ostr(os), len(0) {}
+    TTextWriter(const TTextWriter&) = delete;
+    TTextWriter& operator=(const TTextWriter&) = delete;
+
+    void flush()
+    {
+      if (len != 0)
+        ostr.write(buf, len);
+      len = 0;
+    }
+    void put(char c)
+    {
+      if (len == sizeof(buf))
+        flush();
+      buf[len++] = c;
+    }
+    template<typename T>
+    void put_value(T val)
+    {
+      if (sizeof(buf) - len < 64) // с запасом для самого длинного long double
+        flush();
+      len = to_chars(buf + len, buf + sizeof(buf), val).ptr - buf;
+    }
+    // элементы в формате operator<< вектора: каждый с завершающим пробелом
+    template<typename T>
+    void put_values(const T* p, size_t n)
+    {
+      for (size_t i = 0; i < n; i++)
+      {
+        put_value(p[i]);
+        put(' ');
+      }
+    }
+  };
+}
+
+// Динамический вектор -
 // шаблонный вектор на динамической памяти
 template<typename T>
 class TDynamicVector
@@ -27,29 +193,57 @@ public:
   {
     if (sz == 0)
       throw out_of_range("Vector size should be greater than zero");
+    if (sz > MAX_VECTOR_SIZE)
+      throw out_of_range("Vector size should not exceed MAX_VECTOR_SIZE");
     pMem = new T[sz]();// {}; // У типа T д.б. констуктор по умолчанию
+    TMATRIX_COUNT(TDynamicVector, ALLOC_CONSTRUCT);
+    TMATRIX_COUNT_ALLOC(TDynamicVector, sz * sizeof(T));
   }
   TDynamicVector(T* arr, size_t s) : sz(s)
   {
     assert(arr != nullptr && "TDynamicVector ctor requires non-nullptr arg");
     pMem = new T[sz];
     std::copy(arr, arr + sz, pMem);
+    TMATRIX_COUNT(TDynamicVector, ALLOC_CONSTRUCT);
+    TMATRIX_COUNT_ALLOC(TDynamicVector, sz * sizeof(T));
   }
-  TDynamicVector(const TDynamicVector& v)
+  TDynamicVector(const TDynamicVector& v) : sz(v.sz)
   {
+    pMem = new T[sz];
+    std::copy(v.pMem, v.pMem + sz, pMem);
+    TMATRIX_COUNT(TDynamicVector, ALLOC_COPY_CONSTRUCT);
+    TMATRIX_COUNT_ALLOC(TDynamicVector, sz * sizeof(T));
   }
-  TDynamicVector(TDynamicVector&& v) noexcept
+  TDynamicVector(TDynamicVector&& v) noexcept : sz(0), pMem(nullptr)
   {
+    swap(*this, v);
+    TMATRIX_COUNT(TDynamicVector, ALLOC_MOVE_CONSTRUCT);
   }
   ~TDynamicVector()
   {
+    delete[] pMem;
   }
   TDynamicVector& operator=(const TDynamicVector& v)
   {
+    if (this == &v)
+      return *this;
+    TMATRIX_COUNT(TDynamicVector, ALLOC_COPY_ASSIGN);
+    if (sz != v.sz)
+    {
+      T* p = new T[v.sz];
+      delete[] pMem;
+      pMem = p;
+      sz = v.sz;
+      TMATRIX_COUNT_ALLOC(TDynamicVector, sz * sizeof(T));
+    }
+    std::copy(v.pMem, v.pMem + sz, pMem);
+    return *this;
   }
   TDynamicVector& operator=(TDynamicVector&& v) noexcept
   {
-      return *this;
+    swap(*this, v);
+    TMATRIX_COUNT(TDynamicVector, ALLOC_MOVE_ASSIGN);
+    return *this;
   }
 
   size_t size() const noexcept { return sz; }
@@ -57,46 +251,95 @@ public:
   // индексация
   T& operator[](size_t ind)
   {
+    return pMem[ind];
   }
   const T& operator[](size_t ind) const
   {
+    return pMem[ind];
   }
   // индексация с контролем
   T& at(size_t ind)
   {
+    if (ind >= sz)
+      throw out_of_range("Vector index is out of range");
+    return pMem[ind];
   }
   const T& at(size_t ind) const
   {
+    if (ind >= sz)
+      throw out_of_range("Vector index is out of range");
+    return pMem[ind];
   }
 
   // сравнение
   bool operator==(const TDynamicVector& v) const noexcept
   {
+    if (sz != v.sz)
+      return false;
+    for (size_t i = 0; i < sz; i++)
+      if (pMem[i] != v.pMem[i])
+        return false;
+    return true;
   }
   bool operator!=(const TDynamicVector& v) const noexcept
   {
+    return !(*this == v);
   }
 
   // скалярные операции
-  TDynamicVector operator+(T val)
+  TDynamicVector operator+(T val) const
   {
+    TMATRIX_OP(OP_ADD, sz, sz, sz * sizeof(T), sz * sizeof(T));
+    TDynamicVector res(*this);
+    for (size_t i = 0; i < sz; i++)
+      res.pMem[i] += val;
+    return res;
   }
-  TDynamicVector operator-(double val)
+  TDynamicVector operator-(double val) const
   {
+    TMATRIX_OP(OP_ADD, sz, sz, sz * sizeof(T), sz * sizeof(T));
+    TDynamicVector res(*this);
+    for (size_t i = 0; i < sz; i++)
+      res.pMem[i] -= val;
+    return res;
   }
-  TDynamicVector operator*(double val)
+  TDynamicVector operator*(double val) const
   {
+    TMATRIX_OP(OP_SCALE, sz, sz, sz * sizeof(T), sz * sizeof(T));
+    TDynamicVector res(*this);
+    if constexpr (std::is_floating_point<T>::value)
+      kernels<T>().scale(res.pMem, T(val), sz);
+    else // целочисленный T умножается на double поэлементно, как и раньше
+      for (size_t i = 0; i < sz; i++)
+        res.pMem[i] *= val;
+    return res;
   }
 
   // векторные операции
-  TDynamicVector operator+(const TDynamicVector& v)
+  TDynamicVector operator+(const TDynamicVector& v) const
   {
+    if (sz != v.sz)
+      throw length_error("Vectors should have equal sizes");
+    TMATRIX_OP(OP_ADD, sz, sz, 2 * sz * sizeof(T), sz * sizeof(T));
+    TDynamicVector res(*this);
+    kernels<T>().add(res.pMem, v.pMem, sz);
+    return res;
   }
-  TDynamicVector operator-(const TDynamicVector& v)
+  TDynamicVector operator-(const TDynamicVector& v) const
   {
+    if (sz != v.sz)
+      throw length_error("Vectors should have equal sizes");
+    TMATRIX_OP(OP_ADD, sz, sz, 2 * sz * sizeof(T), sz * sizeof(T));
+    TDynamicVector res(*this);
+    kernels<T>().sub(res.pMem, v.pMem, sz);
+    return res;
   }
-  T operator*(const TDynamicVector& v) noexcept(noexcept(T()))
+  T operator*(const TDynamicVector& v) const
   {
+    if (sz != v.sz)
+      throw length_error("Vectors should have equal sizes");
+    TMATRIX_OP(OP_DOT, sz, 2 * sz, 2 * sz * sizeof(T), 0);
+    return kernels<T>().dot(pMem, v.pMem, sz);
   }
 
   friend void swap(TDynamicVector& lhs, TDynamicVector& rhs) noexcept
@@ -108,67 +351,182 @@ public:
   // ввод/вывод
   friend istream& operator>>(istream& istr, TDynamicVector& v)
   {
+    TMATRIX_OP(OP_IO, v.sz, 0, 0, v.sz * sizeof(T));
+    if constexpr (tmatrix_detail::is_fast_io_v<T>)
+      if (tmatrix_detail::has_default_format(istr))
+      {
+        tmatrix_detail::read_values(istr, v.pMem, v.sz);
+        return istr;
+      }
     for (size_t i = 0; i < v.sz; i++)
       istr >> v.pMem[i]; // требуется оператор>> для типа T
     return istr;
   }
   friend ostream& operator<<(ostream& ostr, const TDynamicVector& v)
   {
+    TMATRIX_OP(OP_IO, v.sz, 0, v.sz * sizeof(T), 0);
+    if constexpr (tmatrix_detail::is_fast_io_v<T>)
+      if (tmatrix_detail::has_default_output_format<T>(ostr))
+      {
+        tmatrix_detail::TTextWriter w(ostr);
+        w.put_values(v.pMem, v.sz);
+        w.flush();
+        return ostr;
+      }
     for (size_t i = 0; i < v.sz; i++)
       ostr << v.pMem[i] << ' '; // требуется оператор<< для типа T
     return ostr;
   }
 };
 
-
-// Динамическая матрица - 
+// Динамическая матрица -
 // шаблонная матрица на динамической памяти
 template<typename T>
 class TDynamicMatrix : private TDynamicVector<TDynamicVector<T>>
 {
   using TDynamicVector<TDynamicVector<T>>::pMem;
   using TDynamicVector<TDynamicVector<T>>::sz;
+
 public:
   TDynamicMatrix(size_t s = 1) : TDynamicVector<TDynamicVector<T>>(s)
   {
+    if (sz > MAX_MATRIX_SIZE)
+      throw out_of_range("Matrix size should not exceed MAX_MATRIX_SIZE");
     for (size_t i = 0; i < sz; i++)
       pMem[i] = TDynamicVector<T>(sz);
+    TMATRIX_COUNT(TDynamicMatrix, ALLOC_CONSTRUCT);
+  }
+  TDynamicMatrix(const TDynamicMatrix& m) : TDynamicVector<TDynamicVector<T>>(m)
+  {
+    TMATRIX_COUNT(TDynamicMatrix, ALLOC_COPY_CONSTRUCT);
+  }
+  TDynamicMatrix(TDynamicMatrix&& m) noexcept : TDynamicVector<TDynamicVector<T>>(std::move(m))
+  {
+    TMATRIX_COUNT(TDynamicMatrix, ALLOC_MOVE_CONSTRUCT);
+  }
+  TDynamicMatrix& operator=(const TDynamicMatrix& m)
+  {
+    TDynamicVector<TDynamicVector<T>>::operator=(m);
+    TMATRIX_COUNT(TDynamicMatrix, ALLOC_COPY_ASSIGN);
+    return *this;
+  }
+  TDynamicMatrix& operator=(TDynamicMatrix&& m) noexcept
+  {
+    TDynamicVector<TDynamicVector<T>>::operator=(std::move(m));
+    TMATRIX_COUNT(TDynamicMatrix, ALLOC_MOVE_ASSIGN);
+    return *this;
   }
 
+  using TDynamicVector<TDynamicVector<T>>::size;
   using TDynamicVector<TDynamicVector<T>>::operator[];
+  using TDynamicVector<TDynamicVector<T>>::at;
+
+  // перестановка строк за O(1): меняются только указатели на данные строк
+  void swap_rows(size_t i, size_t j)
+  {
+    if (i >= sz || j >= sz)
+      throw out_of_range("Matrix row index is out of range");
+    swap(pMem[i], pMem[j]);
+  }
 
   // сравнение
   bool operator==(const TDynamicMatrix& m) const noexcept
   {
+    return TDynamicVector<TDynamicVector<T>>::operator==(m);
+  }
+  bool operator!=(const TDynamicMatrix& m) const noexcept
+  {
+    return !(*this == m);
   }
 
   // матрично-скалярные операции
-  TDynamicVector<T> operator*(const T& val)
+  TDynamicMatrix operator*(const T& val) const
   {
+    TMATRIX_OP(OP_SCALE, sz, sz * sz, sz * sz * sizeof(T), sz * sz * sizeof(T));
+    TDynamicMatrix res(*this);
+    for (size_t i = 0; i < sz; i++)
+      kernels<T>().scale(&res.pMem[i][0], val, sz);
+    return res;
   }
 
   // матрично-векторные операции
-  TDynamicVector<T> operator*(const TDynamicVector<T>& v)
+  TDynamicVector<T> operator*(const TDynamicVector<T>& v) const
   {
+    if (sz != v.size())
+      throw length_error("Matrix and vector sizes are not compatible");
+    TMATRIX_OP(OP_MATVEC, sz, 2 * sz * sz, (sz * sz + sz) * sizeof(T), sz * sizeof(T));
+    TDynamicVector<T> res(sz);
+    gemv_rows(T(1), *this, &v[0], T(), &res[0], sz, sz);
+    return res;
   }
 
   // матрично-матричные операции
-  TDynamicMatrix operator+(const TDynamicMatrix& m)
+  TDynamicMatrix operator+(const TDynamicMatrix& m) const
   {
+    if (sz != m.sz)
+      throw length_error("Matrices should have equal sizes");
+    TMATRIX_OP(OP_ADD, sz, sz * sz, 2 * sz * sz * sizeof(T), sz * sz * sizeof(T));
+    TDynamicMatrix res(*this);
+    for (size_t i = 0; i < sz; i++)
+      kernels<T>().add(&res.pMem[i][0], &m.pMem[i][0], sz);
+    return res;
   }
-  TDynamicMatrix operator-(const TDynamicMatrix& m)
+  TDynamicMatrix operator-(const TDynamicMatrix& m) const
   {
+    if (sz != m.sz)
+      throw length_error("Matrices should have equal sizes");
+    TMATRIX_OP(OP_ADD, sz, sz * sz, 2 * sz * sz * sizeof(T), sz * sz * sizeof(T));
+    TDynamicMatrix res(*this);
+    for (size_t i = 0; i < sz; i++)
+      kernels<T>().sub(&res.pMem[i][0], &m.pMem[i][0], sz);
+    return res;
+  }
+  TDynamicMatrix operator*(const TDynamicMatrix& m) const
+  {
+    if (sz != m.sz)
+      throw length_error("Matrices should have equal sizes");
+    TMATRIX_OP(OP_MATMUL, sz, 2 * sz * sz * sz, 2 * sz * sz * sizeof(T), sz * sz * sizeof(T));
+    TDynamicMatrix res(sz);
+    gemm_rows(T(1), *this, m, T(), res, sz, sz, sz);
+    return res;
   }
-  TDynamicMatrix operator*(const TDynamicMatrix& m)
+  // A B без настроенных размеров блоков (gemm_recursive_rows)
+  friend TDynamicMatrix multiply_recursive(const TDynamicMatrix& a, const TDynamicMatrix& b)
   {
+    if (a.sz != b.sz)
+      throw length_error("Matrices should have equal sizes");
+    TMATRIX_OP(OP_MATMUL, a.sz, 2 * a.sz * a.sz * a.sz, 2 * a.sz * a.sz * sizeof(T), a.sz * a.sz * sizeof(T));
+    TDynamicMatrix res(a.sz);
+    gemm_recursive_rows(a, b, res, a.sz, a.sz, a.sz);
+    return res;
   }
 
   // ввод/вывод
   friend istream& operator>>(istream& istr, TDynamicMatrix& v)
   {
+    TMATRIX_OP(OP_IO, v.sz, 0, 0, v.sz * v.sz * sizeof(T));
+    for (size_t i = 0; i < v.sz && istr; i++)
+      istr >> v.pMem[i];
+    return istr;
   }
   friend ostream& operator<<(ostream& ostr, const TDynamicMatrix& v)
   {
+    TMATRIX_OP(OP_IO, v.sz, 0, v.sz * v.sz * sizeof(T), 0);
+    if constexpr (tmatrix_detail::is_fast_io_v<T>)
+      if (tmatrix_detail::has_default_output_format<T>(ostr))
+      {
+        tmatrix_detail::TTextWriter w(ostr);
+        for (size_t i = 0; i < v.sz; i++)
+        {
+          w.put_values(&v.pMem[i][0], v.sz);
+          w.put('\n');
+        }
+        w.flush();
+        return ostr << flush;
+      }
+    for (size_t i = 0; i < v.sz; i++)
+      ostr << v.pMem[i] << endl;
+    return ostr;
   }
 };
 
@@ -0,0 +1,701 @@
+// ННГУ, ИИТММ, Курс "Алгоритмы и структуры данных"
+//
+// Загрузка и сохранение матриц: большие текстовые файлы, Matrix Market, NumPy .npy
+//
+
+#ifndef __TMatrixIO_H__
+#define __TMatrixIO_H__
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tmatrix.h"
+#include "tparallel.h"
+#include "tsparse.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TMATRIX_HAS_MMAP 1
+#endif
+
+// Файл, отображённый в память (только чтение);
+// без mmap содержимое читается в буфер целиком
+class TMappedFile
+{
+  const char* pData;
+  size_t len;
+  vector<char> buf;
+public:
+  explicit TMappedFile(const string& path) : pData(nullptr), len(0)
+  {
+#ifdef TMATRIX_HAS_MMAP
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw runtime_error("Can't open file " + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+      close(fd);
+      throw runtime_error("Can't stat file " + path);
+    }
+    len = size_t(st.st_size);
+    if (len != 0)
+    {
+      void* p = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p == MAP_FAILED)
+      {
+        close(fd);
+        throw runtime_error("Can't map file " + path);
+      }
+      madvise(p, len, MADV_SEQUENTIAL);
+      pData = static_cast<const char*>(p);
+    }
+    close(fd);
+#else
+    ifstream f(path, ios::binary | ios::ate);
+    if (!f)
+      throw runtime_error("Can't open file " + path);
+    buf.resize(size_t(f.tellg()));
+    f.seekg(0);
+    f.read(buf.data(), buf.size());
+    pData = buf.data();
+    len = buf.size();
+#endif
+  }
+  TMappedFile(const TMappedFile&) = delete;
+  TMappedFile& operator=(const TMappedFile&) = delete;
+  ~TMappedFile()
+  {
+#ifdef TMATRIX_HAS_MMAP
+    if (pData != nullptr)
+      munmap(const_cast<char*>(pData), len);
+#endif
+  }
+
+  const char* data() const noexcept { return pData; }
+  size_t size() const noexcept { return len; }
+};
+
+namespace tmatrix_detail
+{
+  // конец текущей строки (позиция '\n' или last)
+  inline const char* line_end(const char* p, const char* last) noexcept
+  {
+    const void* e = memchr(p, '\n', last - p);
+    return e ? static_cast<const char*>(e) : last;
+  }
+
+  inline bool is_blank(const char* p, const char* last) noexcept
+  {
+    while (p != last && is_space(*p))
+      ++p;
+    return p == last;
+  }
+
+  // начало строки, следующей за pos (для разбиения буфера на блоки строк)
+  inline const char* next_line(const char* first, const char* pos, const char* last) noexcept
+  {
+    if (pos == first)
+      return first;
+    if (pos[-1] == '\n')
+      return pos;
+    const char* e = line_end(pos, last);
+    return e == last ? last : e + 1;
+  }
+
+  // число непустых строк в [first, last)
+  inline size_t count_rows(const char* first, const char* last) noexcept
+  {
+    size_t n = 0;
+    while (first != last)
+    {
+      const char* e = line_end(first, last);
+      if (!is_blank(first, e))
+        n++;
+      first = e == last ? last : e + 1;
+    }
+    return n;
+  }
+}
+
+// Загрузка матрицы из текста в памяти: по одной строке матрицы на строку текста
+// (формат operator<<), пустые строки пропускаются. Текст делится на блоки по
+// границам строк, блоки разбираются параллельно прямо в строки матрицы
+template<typename T>
+void load_text(const char* data, size_t len, TDynamicMatrix<T>& m)
+{
+  static_assert(tmatrix_detail::is_fast_io_v<T>, "load_text requires a built-in arithmetic type");
+  using namespace tmatrix_detail;
+  const char* last = data + len;
+  const size_t n = m.size();
+  TMATRIX_OP(OP_IO, n, 0, len, n * n * sizeof(T));
+  const size_t min_block = size_t(1) << 20;
+  const size_t nblocks = max<size_t>(1, min(TThreadPool::instance().size() * 4, len / min_block));
+
+  vector<const char*> bounds(nblocks + 1);
+  bounds[0] = data;
+  bounds[nblocks] = last;
+  for (size_t k = 1; k < nblocks; k++)
+    bounds[k] = next_line(data, max(bounds[k - 1], data + len / nblocks * k), last);
+
+  // 1-й проход: номер первой строки матрицы в каждом блоке
+  vector<size_t> first_row(nblocks + 1, 0);
+  parallel_for(0, nblocks, 1, [&](size_t b, size_t e) {
+    for (size_t k = b; k < e; k++)
+      first_row[k + 1] = count_rows(bounds[k], bounds[k + 1]);
+  });
+  for (size_t k = 0; k < nblocks; k++)
+    first_row[k + 1] += first_row[k];
+  if (first_row[nblocks] != n)
+    throw invalid_argument("Number of rows in text does not match matrix size");
+
+  // 2-й проход: разбор строк
+  parallel_for(0, nblocks, 1, [&](size_t b, size_t e) {
+    for (size_t k = b; k < e; k++)
+    {
+      size_t row = first_row[k];
+      for (const char* p = bounds[k]; p != bounds[k + 1];)
+      {
+        const char* le = line_end(p, bounds[k + 1]);
+        if (!is_blank(p, le))
+        {
+          const char* pe = parse_values(p, le, &m[row][0], n);
+          if (pe == nullptr || !is_blank(pe, le))
+            throw invalid_argument("Malformed matrix row " + to_string(row));
+          row++;
+        }
+        p = le == bounds[k + 1] ? le : le + 1;
+      }
+    }
+  });
+}
+
+template<typename T>
+void load_text_file(const string& path, TDynamicMatrix<T>& m)
+{
+  TMappedFile f(path);
+  load_text(f.data(), f.size(), m);
+}
+
+// Matrix Market (.mtx): форматы coordinate и array, поля real/double/integer/pattern,
+// симметрии general/symmetric/skew-symmetric
+struct TMtxHeader
+{
+  bool coordinate;
+  bool pattern;
+  int symmetry; // 0 - general, 1 - symmetric, -1 - skew-symmetric
+  size_t rows, cols, nnz;
+};
+
+namespace tmatrix_detail
+{
+  template<typename T>
+  bool read_one(istream& istr, T& val)
+  {
+    if constexpr (is_fast_io_v<T>)
+      read_values(istr, &val, 1);
+    else
+      istr >> val;
+    return bool(istr);
+  }
+
+  inline TMtxHeader mtx_read_header(istream& istr)
+  {
+    string line;
+    if (!getline(istr, line))
+      throw invalid_argument("Matrix Market header is missing");
+    istringstream hs(line);
+    string banner, object, format, field, symmetry;
+    hs >> banner >> object >> format >> field >> symmetry;
+    for (string* s : { &object, &format, &field, &symmetry })
+      transform(s->begin(), s->end(), s->begin(), [](unsigned char c) { return char(tolower(c)); });
+    if (banner != "%%MatrixMarket" || object != "matrix")
+      throw invalid_argument("Not a Matrix Market matrix");
+
+    TMtxHeader h;
+    if (format == "coordinate")
+      h.coordinate = true;
+    else if (format == "array")
+      h.coordinate = false;
+    else
+      throw invalid_argument("Unsupported Matrix Market format " + format);
+    if (field != "real" && field != "double" && field != "integer" && field != "pattern")
+      throw invalid_argument("Unsupported Matrix Market field " + field);
+    h.pattern = field == "pattern";
+    if (h.pattern && !h.coordinate)
+      throw invalid_argument("Pattern field requires coordinate format");
+    if (symmetry == "general")
+      h.symmetry = 0;
+    else if (symmetry == "symmetric")
+      h.symmetry = 1;
+    else if (symmetry == "skew-symmetric")
+      h.symmetry = -1;
+    else
+      throw invalid_argument("Unsupported Matrix Market symmetry " + symmetry);
+
+    while (istr.peek() == '%' || istr.peek() == '\n' || istr.peek() == '\r')
+      getline(istr, line);
+    h.nnz = 0;
+    bool ok = read_one(istr, h.rows) && read_one(istr, h.cols);
+    if (ok && h.coordinate)
+      ok = read_one(istr, h.nnz);
+    if (!ok || h.rows == 0 || h.cols == 0)
+      throw invalid_argument("Malformed Matrix Market size line");
+    if (h.symmetry != 0 && h.rows != h.cols)
+      throw invalid_argument("Symmetric Matrix Market matrix should be square");
+    return h;
+  }
+
+  // обход элементов файла; f(i, j, v) вызывается и для отражённых
+  // относительно диагонали элементов симметричных матриц
+  template<typename T, typename F>
+  void mtx_read_entries(istream& istr, const TMtxHeader& h, F f)
+  {
+    auto emit = [&](size_t i, size_t j, T v) {
+      f(i, j, v);
+      if (h.symmetry != 0 && i != j)
+        f(j, i, h.symmetry > 0 ? v : T() - v);
+    };
+    if (h.coordinate)
+    {
+      for (size_t k = 0; k < h.nnz; k++)
+      {
+        size_t i, j;
+        T v = T(1);
+        if (!read_one(istr, i) || !read_one(istr, j) || (!h.pattern && !read_one(istr, v)))
+          throw invalid_argument("Malformed Matrix Market entry " + to_string(k));
+        if (i == 0 || j == 0 || i > h.rows || j > h.cols)
+          throw out_of_range("Matrix Market entry index is out of range");
+        emit(i - 1, j - 1, v);
+      }
+      return;
+    }
+    // array: по столбцам, для симметричных - только нижний треугольник
+    for (size_t j = 0; j < h.cols; j++)
+      for (size_t i = h.symmetry == 0 ? 0 : j + (h.symmetry < 0 ? 1 : 0); i < h.rows; i++)
+      {
+        T v;
+        if (!read_one(istr, v))
+          throw invalid_argument("Malformed Matrix Market array entry");
+        emit(i, j, v);
+      }
+  }
+
+  template<typename T>
+  const char* mtx_field() noexcept
+  {
+    return is_integral<T>::value ? "integer" : "real";
+  }
+}
+
+// повторяющиеся элементы coordinate суммируются, как в mtx_read для TSparseMatrix
+template<typename T>
+void mtx_read(istream& istr, TDynamicMatrix<T>& m)
+{
+  const TMtxHeader h = tmatrix_detail::mtx_read_header(istr);
+  if (h.rows != h.cols)
+    throw invalid_argument("TDynamicMatrix requires a square Matrix Market matrix");
+  TDynamicMatrix<T> res(h.rows);
+  tmatrix_detail::mtx_read_entries<T>(istr, h, [&res](size_t i, size_t j, T v) { res[i][j] += v; });
+  m = std::move(res);
+}
+
+template<typename T>
+void mtx_read(istream& istr, TSparseMatrix<T>& m)
+{
+  const TMtxHeader h = tmatrix_detail::mtx_read_header(istr);
+  vector<size_t> ri, ci;
+  vector<T> v;
+  const size_t reserve = h.coordinate ? h.nnz * (h.symmetry != 0 ? 2 : 1) : 0;
+  ri.reserve(reserve); ci.reserve(reserve); v.reserve(reserve);
+  tmatrix_detail::mtx_read_entries<T>(istr, h, [&](size_t i, size_t j, T x) {
+    if (h.coordinate || x != T())
+    {
+      ri.push_back(i);
+      ci.push_back(j);
+      v.push_back(x);
+    }
+  });
+  m = TSparseMatrix<T>(h.rows, h.cols, ri, ci, v);
+}
+
+// плотная матрица записывается в формате array (по столбцам)
+template<typename T>
+void mtx_write(ostream& ostr, const TDynamicMatrix<T>& m)
+{
+  static_assert(tmatrix_detail::is_fast_io_v<T>, "mtx_write requires a built-in arithmetic type");
+  ostr << "%%MatrixMarket matrix array " << tmatrix_detail::mtx_field<T>() << " general\n"
+    << m.size() << ' ' << m.size() << '\n';
+  tmatrix_detail::TTextWriter w(ostr);
+  for (size_t j = 0; j < m.size(); j++)
+    for (size_t i = 0; i < m.size(); i++)
+    {
+      w.put_value(m[i][j]);
+      w.put('\n');
+    }
+  w.flush();
+}
+
+// разреженная матрица записывается в формате coordinate
+template<typename T>
+void mtx_write(ostream& ostr, const TSparseMatrix<T>& m)
+{
+  static_assert(tmatrix_detail::is_fast_io_v<T>, "mtx_write requires a built-in arithmetic type");
+  ostr << "%%MatrixMarket matrix coordinate " << tmatrix_detail::mtx_field<T>() << " general\n"
+    << m.rows() << ' ' << m.cols() << ' ' << m.nnz() << '\n';
+  tmatrix_detail::TTextWriter w(ostr);
+  for (size_t i = 0; i < m.rows(); i++)
+    for (size_t k = m.row_ptr()[i]; k < m.row_ptr()[i + 1]; k++)
+    {
+      w.put_value(i + 1);
+      w.put(' ');
+      w.put_value(m.col_ind()[k] + 1);
+      w.put(' ');
+      w.put_value(m.values()[k]);
+      w.put('\n');
+    }
+  w.flush();
+}
+
+// NumPy .npy (версии 1.0-3.0): C- и Fortran-порядок, little-endian типы
+// f4/f8/i4/i8/u4/u8; вектор - массив формы (n,), матрица - (n, n)
+struct TNpyHeader
+{
+  char kind;       // 'f', 'i' или 'u'
+  size_t itemsize;
+  bool fortran;
+  vector<size_t> shape;
+  size_t offset;   // смещение данных от начала файла
+};
+
+namespace tmatrix_detail
+{
+  inline bool little_endian() noexcept
+  {
+    const uint16_t x = 1;
+    unsigned char c;
+    memcpy(&c, &x, 1);
+    return c == 1;
+  }
+
+  template<typename T>
+  constexpr char npy_kind() noexcept
+  {
+    return is_floating_point<T>::value ? 'f' : (is_signed<T>::value ? 'i' : 'u');
+  }
+
+  template<typename T>
+  bool npy_same_type(const TNpyHeader& h) noexcept
+  {
+    return h.kind == npy_kind<T>() && h.itemsize == sizeof(T);
+  }
+
+  // число элементов; переполнение исключено проверкой npy_data_size при разборе
+  inline size_t npy_count(const TNpyHeader& h) noexcept
+  {
+    size_t n = 1;
+    for (size_t d : h.shape)
+      n *= d;
+    return n;
+  }
+
+  // размер данных в байтах с проверкой переполнения size_t
+  inline size_t npy_data_size(const TNpyHeader& h)
+  {
+    size_t n = h.itemsize;
+    for (size_t d : h.shape)
+    {
+      if (d != 0 && n > SIZE_MAX / d)
+        throw invalid_argument("npy array is too large");
+      n *= d;
+    }
+    return n;
+  }
+
+  // разбор словаря заголовка: {'descr': '<f8', 'fortran_order': False, 'shape': (3, 3), }
+  inline TNpyHeader npy_parse_dict(const string& dict, size_t offset)
+  {
+    TNpyHeader h;
+    h.offset = offset;
+    auto value_of = [&dict](const char* key) {
+      const size_t k = dict.find(key);
+      if (k == string::npos)
+        throw invalid_argument(string("npy header has no ") + key);
+      size_t p = dict.find(':', k);
+      if (p == string::npos)
+        throw invalid_argument("Malformed npy header");
+      p++;
+      while (p < dict.size() && dict[p] == ' ')
+        p++;
+      return p;
+    };
+
+    size_t p = value_of("'descr'");
+    if (p + 4 > dict.size() || (dict[p] != '\'' && dict[p] != '"'))
+      throw invalid_argument("Malformed npy descr");
+    const size_t q = dict.find(dict[p], p + 1);
+    const string descr = dict.substr(p + 1, q == string::npos ? string::npos : q - p - 1);
+    if (descr.size() < 3 || (descr[0] != '<' && descr[0] != '|' && descr[0] != '=') ||
+      !little_endian() || (descr[1] != 'f' && descr[1] != 'i' && descr[1] != 'u'))
+      throw invalid_argument("Unsupported npy dtype " + descr);
+    h.kind = descr[1];
+    h.itemsize = size_t(strtoul(descr.c_str() + 2, nullptr, 10));
+    if (h.itemsize != 4 && h.itemsize != 8)
+      throw invalid_argument("Unsupported npy dtype " + descr);
+
+    p = value_of("'fortran_order'");
+    h.fortran = dict.compare(p, 4, "True") == 0;
+
+    p = value_of("'shape'");
+    if (p >= dict.size() || dict[p] != '(')
+      throw invalid_argument("Malformed npy shape");
+    for (p++; p < dict.size() && dict[p] != ')';)
+    {
+      if (dict[p] == ' ' || dict[p] == ',')
+      {
+        p++;
+        continue;
+      }
+      size_t d;
+      const char* e = parse_value(dict.data() + p, dict.data() + dict.size(), d);
+      if (e == nullptr)
+        throw invalid_argument("Malformed npy shape");
+      h.shape.push_back(d);
+      p = e - dict.data();
+    }
+    if (p >= dict.size())
+      throw invalid_argument("Malformed npy shape");
+    if (h.shape.size() > 2)
+      throw invalid_argument("Only one- and two-dimensional npy arrays are supported");
+    npy_data_size(h);
+    return h;
+  }
+
+  // разбор заголовка из начала буфера (prefix - не менее 10 байт)
+  inline size_t npy_header_size(const char* prefix, size_t& dict_pos)
+  {
+    if (memcmp(prefix, "\x93NUMPY", 6) != 0)
+      throw invalid_argument("Not a NumPy .npy file");
+    const unsigned char major = static_cast<unsigned char>(prefix[6]);
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(prefix + 8);
+    if (major == 1)
+    {
+      dict_pos = 10;
+      return size_t(b[0]) | size_t(b[1]) << 8;
+    }
+    if (major == 2 || major == 3)
+    {
+      dict_pos = 12;
+      return size_t(b[0]) | size_t(b[1]) << 8 | size_t(b[2]) << 16 | size_t(b[3]) << 24;
+    }
+    throw invalid_argument("Unsupported .npy version");
+  }
+
+  inline TNpyHeader npy_read_header(const char* data, size_t len)
+  {
+    size_t pos;
+    if (len < 12)
+      throw invalid_argument("Not a NumPy .npy file");
+    const size_t hl = npy_header_size(data, pos);
+    if (pos + hl > len)
+      throw invalid_argument("Truncated .npy header");
+    TNpyHeader h = npy_parse_dict(string(data + pos, hl), pos + hl);
+    if (h.offset > len || npy_data_size(h) > len - h.offset)
+      throw invalid_argument("Truncated .npy data");
+    return h;
+  }
+
+  inline TNpyHeader npy_read_header(istream& istr)
+  {
+    char prefix[12];
+    size_t pos;
+    if (!istr.read(prefix, 10))
+      throw invalid_argument("Not a NumPy .npy file");
+    if (prefix[6] != 1 && !istr.read(prefix + 10, 2))
+      throw invalid_argument("Not a NumPy .npy file");
+    const size_t hl = npy_header_size(prefix, pos);
+    string dict(hl, '\0');
+    if (!istr.read(&dict[0], hl))
+      throw invalid_argument("Truncated .npy header");
+    return npy_parse_dict(dict, pos + hl);
+  }
+
+  // преобразование n элементов формата h в T (данные могут быть не выровнены)
+  template<typename T>
+  void npy_convert(const TNpyHeader& h, const char* src, T* dst, size_t n)
+  {
+    if (npy_same_type<T>(h))
+    {
+      memcpy(dst, src, n * sizeof(T));
+      return;
+    }
+    auto conv = [&](auto tag) {
+      decltype(tag) x;
+      for (size_t i = 0; i < n; i++, src += sizeof(x))
+      {
+        memcpy(&x, src, sizeof(x));
+        dst[i] = static_cast<T>(x);
+      }
+    };
+    if (h.kind == 'f')
+      h.itemsize == 4 ? conv(float()) : conv(double());
+    else if (h.kind == 'i')
+      h.itemsize == 4 ? conv(int32_t()) : conv(int64_t());
+    else
+      h.itemsize == 4 ? conv(uint32_t()) : conv(uint64_t());
+  }
+
+  inline void npy_check_shape(const TNpyHeader& h, size_t dims)
+  {
+    if (h.shape.size() != dims || h.shape[0] == 0 || (dims == 2 && h.shape[0] != h.shape[1]))
+      throw invalid_argument(dims == 1 ? "npy array should have shape (n,)" : "npy array should have shape (n, n)");
+  }
+
+  // данные матрицы (C- или Fortran-порядок) из памяти
+  template<typename T>
+  void npy_fill(const TNpyHeader& h, const char* data, TDynamicMatrix<T>& m)
+  {
+    const size_t n = h.shape[0];
+    TDynamicMatrix<T> res(n);
+    if (!h.fortran)
+      for (size_t i = 0; i < n; i++)
+        npy_convert(h, data + i * n * h.itemsize, &res[i][0], n);
+    else
+    {
+      TDynamicVector<T> col(n);
+      for (size_t j = 0; j < n; j++)
+      {
+        npy_convert(h, data + j * n * h.itemsize, &col[0], n);
+        for (size_t i = 0; i < n; i++)
+          res[i][j] = col[i];
+      }
+    }
+    m = std::move(res);
+  }
+
+  template<typename T>
+  void npy_write_header(ostream& ostr, const vector<size_t>& shape)
+  {
+    static_assert(is_arithmetic<T>::value && !is_same<T, bool>::value &&
+      (sizeof(T) == 4 || sizeof(T) == 8), "npy supports 4- and 8-byte arithmetic types");
+    if (!little_endian())
+      throw runtime_error("npy writer supports little-endian hosts only");
+    string dict = string("{'descr': '<") + npy_kind<T>() + to_string(sizeof(T)) +
+      "', 'fortran_order': False, 'shape': (";
+    for (size_t d : shape)
+      dict += to_string(d) + ", ";
+    dict += "), }";
+    // данные выравниваются на 64 байта, словарь завершается '\n'
+    const size_t total = (10 + dict.size() + 1 + 63) / 64 * 64;
+    dict.append(total - 10 - dict.size() - 1, ' ');
+    dict += '\n';
+    const size_t hl = dict.size();
+    const char prefix[10] = { '\x93', 'N', 'U', 'M', 'P', 'Y', 1, 0, char(hl & 0xff), char(hl >> 8) };
+    ostr.write(prefix, 10);
+    ostr.write(dict.data(), dict.size());
+  }
+}
+
+template<typename T>
+void npy_read(istream& istr, TDynamicVector<T>& v)
+{
+  const TNpyHeader h = tmatrix_detail::npy_read_header(istr);
+  tmatrix_detail::npy_check_shape(h, 1);
+  vector<char> buf(h.shape[0] * h.itemsize);
+  if (!istr.read(buf.data(), buf.size()))
+    throw invalid_argument("Truncated .npy data");
+  TDynamicVector<T> res(h.shape[0]);
+  tmatrix_detail::npy_convert(h, buf.data(), &res[0], res.size());
+  v = std::move(res);
+}
+
+template<typename T>
+void npy_read(istream& istr, TDynamicMatrix<T>& m)
+{
+  const TNpyHeader h = tmatrix_detail::npy_read_header(istr);
+  tmatrix_detail::npy_check_shape(h, 2);
+  vector<char> buf(h.shape[0] * h.shape[1] * h.itemsize);
+  if (!istr.read(buf.data(), buf.size()))
+    throw invalid_argument("Truncated .npy data");
+  tmatrix_detail::npy_fill(h, buf.data(), m);
+}
+
+// загрузка из файла через отображение в память без промежуточного буфера
+template<typename T>
+void npy_read_file(const string& path, TDynamicVector<T>& v)
+{
+  TMappedFile f(path);
+  const TNpyHeader h = tmatrix_detail::npy_read_header(f.data(), f.size());
+  tmatrix_detail::npy_check_shape(h, 1);
+  TDynamicVector<T> res(h.shape[0]);
+  tmatrix_detail::npy_convert(h, f.data() + h.offset, &res[0], res.size());
+  v = std::move(res);
+}
+
+template<typename T>
+void npy_read_file(const string& path, TDynamicMatrix<T>& m)
+{
+  TMappedFile f(path);
+  const TNpyHeader h = tmatrix_detail::npy_read_header(f.data(), f.size());
+  tmatrix_detail::npy_check_shape(h, 2);
+  tmatrix_detail::npy_fill(h, f.data() + h.offset, m);
+}
+
+template<typename T>
+void npy_write(ostream& ostr, const TDynamicVector<T>& v)
+{
+  tmatrix_detail::npy_write_header<T>(ostr, { v.size() });
+  ostr.write(reinterpret_cast<const char*>(&v[0]), v.size() * sizeof(T));
+}
+
+template<typename T>
+void npy_write(ostream& ostr, const TDynamicMatrix<T>& m)
+{
+  tmatrix_detail::npy_write_header<T>(ostr, { m.size(), m.size() });
+  for (size_t i = 0; i < m.size(); i++)
+    ostr.write(reinterpret_cast<const char*>(&m[i][0]), m.size() * sizeof(T));
+}
+
+// Массив .npy без копирования -
+// доступ только для чтения прямо к отображённому в память файлу; требует
+// совпадения типа, C-порядка и выравнивания данных, иначе - исключение
+// (в этом случае следует использовать npy_read_file)
+template<typename T>
+class TNpyView
+{
+  unique_ptr<TMappedFile> file;
+  TNpyHeader hdr;
+  const T* pData;
+public:
+  explicit TNpyView(const string& path) : file(new TMappedFile(path))
+  {
+    hdr = tmatrix_detail::npy_read_header(file->data(), file->size());
+    if (!tmatrix_detail::npy_same_type<T>(hdr) || hdr.fortran)
+      throw invalid_argument("npy data can't be viewed as C-ordered array of T");
+    const char* p = file->data() + hdr.offset;
+    if (reinterpret_cast<uintptr_t>(p) % alignof(T) != 0)
+      throw invalid_argument("npy data is not aligned for T");
+    pData = reinterpret_cast<const T*>(p);
+  }
+
+  const vector<size_t>& shape() const noexcept { return hdr.shape; }
+  size_t size() const noexcept { return tmatrix_detail::npy_count(hdr); }
+  const T* data() const noexcept { return pData; }
+
+  // строка двумерного массива
+  const T* operator[](size_t i) const
+  {
+    return pData + i * (hdr.shape.size() > 1 ? hdr.shape[1] : 1);
+  }
+};
+
+#endif
@@ -0,0 +1,193 @@
+// ННГУ, ИИТММ, Курс "Алгоритмы и структуры данных"
+//
+// Линейный оператор без хранения матрицы
+//
+// Оператор задаётся функцией y = A x (и, если нужно, y = A^T x); плотная,
+// разреженная, диагональная матрица и произвольная функция приводятся
+// к одному типу TLinearOperator. Операторы из матриц ссылаются на матрицу:
+// она должна существовать и сохранять размер, пока используется оператор,
+// а изменения её элементов и перестановки строк видны оператору сразу.
+// Временные матрицы не принимаются
+//
+
+#ifndef __TOperator_H__
+#define __TOperator_H__
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "tgemm.h"
+#include "tmatrix.h"
+#include "tsparse.h"
+
+using namespace std;
+
+template<typename T>
+class TLinearOperator
+{
+public:
+  // y = A x, y уже имеет нужный размер
+  using TApply = function<void(const TDynamicVector<T>& x, TDynamicVector<T>& y)>;
+  // Y[j] = A X[j] для блока векторов
+  using TApplyBlock = function<void(const TDynamicVector<TDynamicVector<T>>& x, TDynamicVector<TDynamicVector<T>>& y)>;
+private:
+  size_t nrows, ncols;
+  TApply fwd, adj;
+  TApplyBlock block;
+
+  static void check(const TDynamicVector<T>& x, size_t nx, const TDynamicVector<T>& y, size_t ny)
+  {
+    if (x.size() != nx || y.size() != ny)
+      throw length_error("Vector sizes are not compatible with the operator");
+  }
+public:
+  // apply_t и apply_block необязательны: без apply_t транспонирование недоступно,
+  // без apply_block блок обрабатывается по одному вектору
+  TLinearOperator(size_t rows, size_t cols, TApply apply, TApply apply_t = nullptr,
+    TApplyBlock apply_block = nullptr)
+    : nrows(rows), ncols(cols), fwd(std::move(apply)), adj(std::move(apply_t)), block(std::move(apply_block))
+  {
+    if (rows == 0 || cols == 0)
+      throw out_of_range("Operator size should be greater than zero");
+    if (!fwd)
+      throw invalid_argument("Operator requires an apply function");
+  }
+
+  size_t rows() const noexcept { return nrows; }
+  size_t cols() const noexcept { return ncols; }
+  bool has_transpose() const noexcept { return bool(adj); }
+
+  void apply(const TDynamicVector<T>& x, TDynamicVector<T>& y) const
+  {
+    check(x, ncols, y, nrows);
+    fwd(x, y);
+  }
+  void apply_transpose(const TDynamicVector<T>& x, TDynamicVector<T>& y) const
+  {
+    if (!adj)
+      throw logic_error("Operator has no transpose");
+    check(x, nrows, y, ncols);
+    adj(x, y);
+  }
+  void apply(const TDynamicVector<TDynamicVector<T>>& x, TDynamicVector<TDynamicVector<T>>& y) const
+  {
+    if (x.size() != y.size())
+      throw length_error("Blocks should have the same number of vectors");
+    for (size_t j = 0; j < x.size(); j++)
+      check(x[j], ncols, y[j], nrows);
+    if (block)
+      block(x, y);
+    else
+      for (size_t j = 0; j < x.size(); j++)
+        fwd(x[j], y[j]);
+  }
+  // для итерационных решателей: op(x, y)
+  void operator()(const TDynamicVector<T>& x, TDynamicVector<T>& y) const { apply(x, y); }
+
+  TDynamicVector<T> operator*(const TDynamicVector<T>& x) const
+  {
+    TDynamicVector<T> y(nrows);
+    apply(x, y);
+    return y;
+  }
+
+  // A^T; блок - по одному вектору
+  TLinearOperator transpose() const
+  {
+    if (!adj)
+      throw logic_error("Operator has no transpose");
+    return TLinearOperator(ncols, nrows, adj, fwd);
+  }
+};
+
+namespace tmatrix_detail
+{
+  // размер матрицы не должен меняться после создания оператора
+  template<typename T>
+  void check_operator_matrix(const TDynamicMatrix<T>& a, size_t n)
+  {
+    if (a.size() != n)
+      throw logic_error("Matrix size changed after the operator was created");
+  }
+  template<typename T>
+  void check_operator_matrix(const TSparseMatrix<T>& a, size_t m, size_t n)
+  {
+    if (a.rows() != m || a.cols() != n)
+      throw logic_error("Matrix size changed after the operator was created");
+  }
+}
+
+// плотная матрица: указатели на строки берутся при каждом применении;
+// блок векторов проходит по строкам A один раз
+template<typename T>
+TLinearOperator<T> make_operator(const TDynamicMatrix<T>& a)
+{
+  const size_t n = a.size();
+  const TDynamicMatrix<T>* pa = &a;
+  auto fwd = [pa, n](const TDynamicVector<T>& x, TDynamicVector<T>& y) {
+    tmatrix_detail::check_operator_matrix(*pa, n);
+    gemv_rows(T(1), *pa, &x[0], T(), &y[0], n, n);
+  };
+  auto adj = [pa, n](const TDynamicVector<T>& x, TDynamicVector<T>& y) {
+    tmatrix_detail::check_operator_matrix(*pa, n);
+    // y = сумма x_i A_i по строкам A
+    const TKernelTable<T>& kern = kernels<T>();
+    fill(&y[0], &y[0] + n, T());
+    for (size_t i = 0; i < n; i++)
+      kern.axpy(&y[0], &(*pa)[i][0], x[i], n);
+  };
+  auto block = [pa, n](const TDynamicVector<TDynamicVector<T>>& x, TDynamicVector<TDynamicVector<T>>& y) {
+    tmatrix_detail::check_operator_matrix(*pa, n);
+    const TKernelTable<T>& kern = kernels<T>();
+    parallel_for(0, n, 64, [&](size_t b, size_t e) {
+      for (size_t i = b; i < e; i++)
+        for (size_t j = 0; j < x.size(); j++)
+          y[j][i] = kern.dot(&(*pa)[i][0], &x[j][0], n);
+    });
+  };
+  return TLinearOperator<T>(n, n, fwd, adj, block);
+}
+// оператор от временной матрицы ссылался бы на уничтоженный объект
+template<typename T>
+TLinearOperator<T> make_operator(const TDynamicMatrix<T>&&) = delete;
+
+template<typename T>
+TLinearOperator<T> make_operator(const TSparseMatrix<T>& a)
+{
+  const TSparseMatrix<T>* pa = &a;
+  const size_t m = a.rows(), n = a.cols();
+  auto fwd = [pa, m, n](const TDynamicVector<T>& x, TDynamicVector<T>& y) {
+    tmatrix_detail::check_operator_matrix(*pa, m, n);
+    pa->multiply(x, y);
+  };
+  auto adj = [pa, m, n](const TDynamicVector<T>& x, TDynamicVector<T>& y) {
+    tmatrix_detail::check_operator_matrix(*pa, m, n);
+    const vector<size_t>& rp = pa->row_ptr();
+    const vector<size_t>& ci = pa->col_ind();
+    const vector<T>& v = pa->values();
+    fill(&y[0], &y[0] + y.size(), T());
+    for (size_t i = 0; i < m; i++)
+      for (size_t k = rp[i]; k < rp[i + 1]; k++)
+        y[ci[k]] += v[k] * x[i];
+  };
+  return TLinearOperator<T>(m, n, fwd, adj);
+}
+template<typename T>
+TLinearOperator<T> make_operator(const TSparseMatrix<T>&&) = delete;
+
+// диагональная матрица diag(d); хранит копию d
+template<typename T>
+TLinearOperator<T> diagonal_operator(const TDynamicVector<T>& d)
+{
+  auto diag = make_shared<TDynamicVector<T>>(d);
+  auto fwd = [diag](const TDynamicVector<T>& x, TDynamicVector<T>& y) {
+    for (size_t i = 0; i < x.size(); i++)
+      y[i] = (*diag)[i] * x[i];
+  };
+  return TLinearOperator<T>(d.size(), d.size(), fwd, fwd);
+}
+
+#endif
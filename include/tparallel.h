@@ -0,0 +1,192 @@
+// ННГУ, ИИТММ, Курс "Алгоритмы и структуры данных"
+//
+// Пул потоков и параллельные циклы для операций над матрицами
+//
+
+#ifndef __TParallel_H__
+#define __TParallel_H__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Пул потоков -
+// общая очередь задач; ожидающий поток сам выполняет задачи из очереди,
+// поэтому вложенные группы задач не приводят к взаимной блокировке
+class TThreadPool
+{
+  vector<thread> workers;
+  deque<function<void()>> tasks;
+  mutex mtx;
+  condition_variable cv;
+  bool stop;
+
+  void worker()
+  {
+    for (;;)
+    {
+      function<void()> task;
+      {
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [this] { return stop || !tasks.empty(); });
+        if (stop && tasks.empty())
+          return;
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      }
+      task();
+    }
+  }
+public:
+  // nthreads - общее число потоков, включая вызывающий
+  explicit TThreadPool(size_t nthreads) : stop(false)
+  {
+    for (size_t i = 1; i < nthreads; i++)
+      workers.emplace_back(&TThreadPool::worker, this);
+  }
+  TThreadPool(const TThreadPool&) = delete;
+  TThreadPool& operator=(const TThreadPool&) = delete;
+  ~TThreadPool()
+  {
+    {
+      lock_guard<mutex> lock(mtx);
+      stop = true;
+    }
+    cv.notify_all();
+    for (auto& w : workers)
+      w.join();
+  }
+
+  // общий пул библиотеки; размер задаётся TMATRIX_NUM_THREADS
+  static TThreadPool& instance()
+  {
+    static TThreadPool pool(default_size());
+    return pool;
+  }
+  static size_t default_size()
+  {
+    if (const char* env = getenv("TMATRIX_NUM_THREADS"))
+    {
+      const long n = strtol(env, nullptr, 10);
+      if (n > 0)
+        return size_t(n);
+    }
+    return max(1u, thread::hardware_concurrency());
+  }
+
+  size_t size() const noexcept { return workers.size() + 1; }
+
+  void push(function<void()> task)
+  {
+    {
+      lock_guard<mutex> lock(mtx);
+      tasks.push_back(std::move(task));
+    }
+    cv.notify_one();
+  }
+  // выполнить одну задачу из очереди в текущем потоке
+  bool try_run_one()
+  {
+    function<void()> task;
+    {
+      lock_guard<mutex> lock(mtx);
+      if (tasks.empty())
+        return false;
+      task = std::move(tasks.back());
+      tasks.pop_back();
+    }
+    task();
+    return true;
+  }
+};
+
+// Группа задач -
+// запуск задач в пуле и ожидание их завершения с передачей исключения
+class TTaskGroup
+{
+  TThreadPool& pool;
+  atomic<size_t> pending;
+  exception_ptr error;
+  mutex mtx;
+public:
+  explicit TTaskGroup(TThreadPool& p = TThreadPool::instance()) : pool(p), pending(0) {}
+  TTaskGroup(const TTaskGroup&) = delete;
+  TTaskGroup& operator=(const TTaskGroup&) = delete;
+  ~TTaskGroup()
+  {
+    while (pending.load(memory_order_acquire) != 0)
+      if (!pool.try_run_one())
+        this_thread::yield();
+  }
+
+  template<typename F>
+  void run(F f)
+  {
+    pending.fetch_add(1, memory_order_relaxed);
+    pool.push([this, f]() mutable {
+      try
+      {
+        f();
+      }
+      catch (...)
+      {
+        lock_guard<mutex> lock(mtx);
+        if (!error)
+          error = current_exception();
+      }
+      pending.fetch_sub(1, memory_order_release);
+    });
+  }
+  void wait()
+  {
+    while (pending.load(memory_order_acquire) != 0)
+      if (!pool.try_run_one())
+        this_thread::yield();
+    if (error)
+    {
+      exception_ptr e = error;
+      error = nullptr;
+      rethrow_exception(e);
+    }
+  }
+};
+
+// Параллельный цикл по [first, last) блоками не меньше grain:
+// f(begin, end) вызывается для каждого блока, последний блок - в текущем потоке
+template<typename F>
+void parallel_for(size_t first, size_t last, size_t grain, F f)
+{
+  if (first >= last)
+    return;
+  TThreadPool& pool = TThreadPool::instance();
+  const size_t n = last - first;
+  grain = max<size_t>(grain, 1);
+  const size_t nblocks = min(pool.size(), (n + grain - 1) / grain);
+  if (nblocks <= 1)
+  {
+    f(first, last);
+    return;
+  }
+  TTaskGroup group(pool);
+  const size_t step = n / nblocks, rem = n % nblocks;
+  size_t b = first;
+  for (size_t k = 0; k + 1 < nblocks; k++)
+  {
+    const size_t e = b + step + (k < rem ? 1 : 0);
+    group.run([&f, b, e] { f(b, e); });
+    b = e;
+  }
+  f(b, last);
+  group.wait();
+}
+
+#endif
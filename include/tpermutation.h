@@ -0,0 +1,106 @@
+// ННГУ, ИИТММ, Курс "Алгоритмы и структуры данных"
+//
+// Перестановка строк матрицы
+//
+
+#ifndef __TPermutation_H__
+#define __TPermutation_H__
+
+#include <stdexcept>
+#include <utility>
+
+#include "tmatrix.h"
+
+using namespace std;
+
+// Перестановка -
+// p[i] - номер исходной строки, стоящей на месте i; применение к матрице
+// выполняется обменами строк по циклам перестановки, каждый обмен - O(1)
+class TPermutation
+{
+  TDynamicVector<size_t> p;
+  int sgn;
+
+  void check(size_t i) const
+  {
+    if (i >= p.size())
+      throw out_of_range("Permutation index is out of range");
+  }
+
+  // обходит циклы перестановки, вызывая swap_at(i, j) для каждого обмена
+  template<typename F>
+  void for_each_swap(F swap_at) const
+  {
+    TDynamicVector<bool> done(p.size());
+    for (size_t s = 0; s < p.size(); s++)
+    {
+      if (done[s])
+        continue;
+      done[s] = true;
+      for (size_t j = s; p[j] != s; j = p[j])
+      {
+        swap_at(j, p[j]);
+        done[p[j]] = true;
+      }
+    }
+  }
+public:
+  // тождественная перестановка
+  explicit TPermutation(size_t n = 1) : p(n), sgn(1)
+  {
+    for (size_t i = 0; i < n; i++)
+      p[i] = i;
+  }
+
+  size_t size() const noexcept { return p.size(); }
+  size_t operator[](size_t i) const { return p[i]; }
+  // +1 для чётной перестановки, -1 для нечётной
+  int sign() const noexcept { return sgn; }
+
+  bool operator==(const TPermutation& q) const noexcept { return p == q.p; }
+  bool operator!=(const TPermutation& q) const noexcept { return p != q.p; }
+
+  // транспозиция мест i и j
+  void swap(size_t i, size_t j)
+  {
+    check(i);
+    check(j);
+    if (i == j)
+      return;
+    std::swap(p[i], p[j]);
+    sgn = -sgn;
+  }
+
+  TPermutation inverse() const
+  {
+    TPermutation q(p.size());
+    for (size_t i = 0; i < p.size(); i++)
+      q.p[p[i]] = i;
+    q.sgn = sgn;
+    return q;
+  }
+
+  // m[i] = m[p[i]] (строки переставляются без копирования данных)
+  template<typename T>
+  void apply(TDynamicMatrix<T>& m) const
+  {
+    if (m.size() != p.size())
+      throw length_error("Permutation size should match the matrix size");
+    for_each_swap([&m](size_t i, size_t j) { m.swap_rows(i, j); });
+  }
+  template<typename T>
+  void apply(TDynamicVector<T>& v) const
+  {
+    if (v.size() != p.size())
+      throw length_error("Permutation size should match the vector size");
+    for_each_swap([&v](size_t i, size_t j) { std::swap(v[i], v[j]); });
+  }
+  // то же для строк длины ncols, заданных указателями
+  template<typename T>
+  void apply_rows(T* const* rows, size_t ncols) const
+  {
+    for_each_swap([rows, ncols](size_t i, size_t j) { swap_ranges(rows[i], rows[i] + ncols, rows[j]); });
+  }
+};
+
+#endif
@@ -0,0 +1,529 @@
+// ННГУ, ИИТММ, Курс "Алгоритмы и структуры данных"
+//
+// Инструментирование векторов и матриц (включается при компиляции)
+//
+// TMATRIX_INSTRUMENT - счётчики конструирования, копирования, перемещения
+//   и выделений памяти для каждого типа
+// TMATRIX_ACCOUNTING - учёт числа вызовов, операций с плавающей точкой,
+//   объёма прочитанной/записанной памяти и времени по видам операций
+// TMATRIX_PERF_COUNTERS - аппаратные счётчики (такты, инструкции, промахи кэша)
+//   по видам операций через perf_event_open (Linux); если счётчики недоступны,
+//   учитывается только время
+// TMATRIX_TRACE - запись начала/конца операций в буферы потоков и выгрузка
+//   в формате Chrome trace events (chrome://tracing, Perfetto)
+//
+
+#ifndef __TProfile_H__
+#define __TProfile_H__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Счётчики выделений и копирований
+
+enum TAllocEvent
+{
+  ALLOC_CONSTRUCT,      // конструирование (кроме копирования и перемещения)
+  ALLOC_COPY_CONSTRUCT,
+  ALLOC_MOVE_CONSTRUCT,
+  ALLOC_COPY_ASSIGN,
+  ALLOC_MOVE_ASSIGN,
+  ALLOC_ALLOCATION,     // выделения памяти под элементы
+  ALLOC_BYTES,          // байт выделено
+  ALLOC_EVENT_COUNT
+};
+
+struct TAllocStats
+{
+  size_t constructions;
+  size_t copy_constructions;
+  size_t move_constructions;
+  size_t copy_assignments;
+  size_t move_assignments;
+  size_t allocations;
+  size_t bytes_allocated;
+
+  TAllocStats operator-(const TAllocStats& s) const noexcept
+  {
+    return { constructions - s.constructions, copy_constructions - s.copy_constructions,
+      move_constructions - s.move_constructions, copy_assignments - s.copy_assignments,
+      move_assignments - s.move_assignments, allocations - s.allocations,
+      bytes_allocated - s.bytes_allocated };
+  }
+};
+
+// Счётчики типа C (например, TDynamicVector<double>);
+// TAllocCounter<void> - суммарные выделения памяти всех типов
+template<typename C>
+class TAllocCounter
+{
+  static inline atomic<size_t> cnt[ALLOC_EVENT_COUNT] = {};
+public:
+  static void add(TAllocEvent e, size_t k = 1) noexcept
+  {
+    cnt[e].fetch_add(k, memory_order_relaxed);
+  }
+  static void add_allocation(size_t bytes) noexcept
+  {
+    add(ALLOC_ALLOCATION);
+    add(ALLOC_BYTES, bytes);
+    if constexpr (!is_same<C, void>::value)
+      TAllocCounter<void>::add_allocation(bytes);
+  }
+  static TAllocStats snapshot() noexcept
+  {
+    return { cnt[ALLOC_CONSTRUCT].load(), cnt[ALLOC_COPY_CONSTRUCT].load(),
+      cnt[ALLOC_MOVE_CONSTRUCT].load(), cnt[ALLOC_COPY_ASSIGN].load(),
+      cnt[ALLOC_MOVE_ASSIGN].load(), cnt[ALLOC_ALLOCATION].load(), cnt[ALLOC_BYTES].load() };
+  }
+  static void reset() noexcept
+  {
+    for (auto& c : cnt)
+      c.store(0, memory_order_relaxed);
+  }
+};
+
+#ifdef TMATRIX_INSTRUMENT
+#define TMATRIX_COUNT(C, e) TAllocCounter<C>::add(e)
+#define TMATRIX_COUNT_ALLOC(C, bytes) TAllocCounter<C>::add_allocation(bytes)
+#else
+#define TMATRIX_COUNT(C, e) ((void)0)
+#define TMATRIX_COUNT_ALLOC(C, bytes) ((void)0)
+#endif
+
+// Учёт операций
+
+enum TOpKind
+{
+  OP_ADD,    // сложение/вычитание векторов и матриц, в т.ч. со скаляром
+  OP_SCALE,  // умножение на скаляр
+  OP_DOT,    // скалярное произведение
+  OP_MATVEC, // умножение матрицы на вектор
+  OP_MATMUL, // умножение матриц
+  OP_IO,     // ввод/вывод
+  OP_KIND_COUNT
+};
+
+struct TOpStats
+{
+  uint64_t calls;
+  uint64_t flops;
+  uint64_t bytes_read;
+  uint64_t bytes_written;
+  double seconds;
+};
+
+class TOpAccounting
+{
+  enum { CALLS, FLOPS, READ, WRITTEN, NANOSECONDS, FIELD_COUNT };
+  static inline atomic<uint64_t> cnt[OP_KIND_COUNT][FIELD_COUNT] = {};
+public:
+  static const char* name(TOpKind k) noexcept
+  {
+    static const char* names[OP_KIND_COUNT] = { "add", "scale", "dot", "matvec", "matmul", "io" };
+    return names[k];
+  }
+  static void record(TOpKind k, uint64_t flops, uint64_t rd, uint64_t wr, uint64_t ns) noexcept
+  {
+    cnt[k][CALLS].fetch_add(1, memory_order_relaxed);
+    cnt[k][FLOPS].fetch_add(flops, memory_order_relaxed);
+    cnt[k][READ].fetch_add(rd, memory_order_relaxed);
+    cnt[k][WRITTEN].fetch_add(wr, memory_order_relaxed);
+    cnt[k][NANOSECONDS].fetch_add(ns, memory_order_relaxed);
+  }
+  static TOpStats stats(TOpKind k) noexcept
+  {
+    return { cnt[k][CALLS].load(), cnt[k][FLOPS].load(), cnt[k][READ].load(),
+      cnt[k][WRITTEN].load(), double(cnt[k][NANOSECONDS].load()) * 1e-9 };
+  }
+  static void reset() noexcept
+  {
+    for (auto& op : cnt)
+      for (auto& c : op)
+        c.store(0, memory_order_relaxed);
+  }
+  static void dump_json(ostream& ostr)
+  {
+    ostr << "{";
+    for (int k = 0; k < OP_KIND_COUNT; k++)
+    {
+      const TOpStats s = stats(TOpKind(k));
+      ostr << (k ? ", " : "") << '"' << name(TOpKind(k)) << "\": {\"calls\": " << s.calls
+        << ", \"flops\": " << s.flops << ", \"bytes_read\": " << s.bytes_read
+        << ", \"bytes_written\": " << s.bytes_written << ", \"seconds\": " << s.seconds << "}";
+    }
+    ostr << "}";
+  }
+};
+
+// Область учёта одной операции; учитывается только внешняя операция потока,
+// вложенные (например, строки при вводе матрицы) в неё уже входят
+class TOpScope
+{
+  static inline thread_local int depth = 0;
+  TOpKind kind;
+  uint64_t flops, rd, wr;
+  chrono::steady_clock::time_point start;
+public:
+  TOpScope(TOpKind k, uint64_t flops_, uint64_t rd_, uint64_t wr_) noexcept
+    : kind(k), flops(flops_), rd(rd_), wr(wr_)
+  {
+    if (depth++ == 0)
+      start = chrono::steady_clock::now();
+  }
+  TOpScope(const TOpScope&) = delete;
+  TOpScope& operator=(const TOpScope&) = delete;
+  ~TOpScope()
+  {
+    if (--depth == 0)
+    {
+      const auto ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+      TOpAccounting::record(kind, flops, rd, wr, uint64_t(ns.count()));
+    }
+  }
+};
+
+// Аппаратные счётчики
+
+enum TPerfEvent
+{
+  PERF_CYCLES,
+  PERF_INSTRUCTIONS,
+  PERF_CACHE_MISSES,
+  PERF_LLC_MISSES,
+  PERF_EVENT_COUNT
+};
+
+struct TPerfStats
+{
+  uint64_t calls;
+  double seconds;
+  uint64_t cycles;
+  uint64_t instructions;
+  uint64_t cache_misses;
+  uint64_t llc_misses;
+  bool counters;       // были ли доступны счётчики (иначе - только время)
+};
+
+// Счётчики текущего потока: открываются при первом использовании, события,
+// которые ядро не поддерживает или запрещает, остаются недоступными
+class TPerfCounters
+{
+  int fd[PERF_EVENT_COUNT];
+
+  TPerfCounters()
+  {
+    for (int& f : fd)
+      f = -1;
+#ifdef __linux__
+    const uint32_t types[PERF_EVENT_COUNT] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+      PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE };
+    const uint64_t configs[PERF_EVENT_COUNT] = { PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) };
+    for (int e = 0; e < PERF_EVENT_COUNT; e++)
+    {
+      perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = types[e];
+      attr.config = configs[e];
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      fd[e] = int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+  }
+public:
+  TPerfCounters(const TPerfCounters&) = delete;
+  TPerfCounters& operator=(const TPerfCounters&) = delete;
+  ~TPerfCounters()
+  {
+#ifdef __linux__
+    for (int f : fd)
+      if (f >= 0)
+        close(f);
+#endif
+  }
+
+  static TPerfCounters& local()
+  {
+    static thread_local TPerfCounters counters;
+    return counters;
+  }
+
+  bool available() const noexcept
+  {
+    return fd[PERF_CYCLES] >= 0 || fd[PERF_INSTRUCTIONS] >= 0;
+  }
+  // текущие значения; недоступные события - нули
+  void read_all(uint64_t (&val)[PERF_EVENT_COUNT]) const noexcept
+  {
+    for (int e = 0; e < PERF_EVENT_COUNT; e++)
+    {
+      val[e] = 0;
+#ifdef __linux__
+      if (fd[e] >= 0 && ::read(fd[e], &val[e], sizeof(val[e])) != sizeof(val[e]))
+        val[e] = 0;
+#endif
+    }
+  }
+};
+
+class TPerfReport
+{
+  enum { CALLS = PERF_EVENT_COUNT, NANOSECONDS, WITH_COUNTERS, FIELD_COUNT };
+  static inline atomic<uint64_t> cnt[OP_KIND_COUNT][FIELD_COUNT] = {};
+public:
+  static void record(TOpKind k, const uint64_t (&delta)[PERF_EVENT_COUNT], uint64_t ns, bool counters) noexcept
+  {
+    for (int e = 0; e < PERF_EVENT_COUNT; e++)
+      cnt[k][e].fetch_add(delta[e], memory_order_relaxed);
+    cnt[k][CALLS].fetch_add(1, memory_order_relaxed);
+    cnt[k][NANOSECONDS].fetch_add(ns, memory_order_relaxed);
+    cnt[k][WITH_COUNTERS].fetch_add(counters ? 1 : 0, memory_order_relaxed);
+  }
+  static TPerfStats stats(TOpKind k) noexcept
+  {
+    return { cnt[k][CALLS].load(), double(cnt[k][NANOSECONDS].load()) * 1e-9,
+      cnt[k][PERF_CYCLES].load(), cnt[k][PERF_INSTRUCTIONS].load(),
+      cnt[k][PERF_CACHE_MISSES].load(), cnt[k][PERF_LLC_MISSES].load(),
+      cnt[k][WITH_COUNTERS].load() != 0 };
+  }
+  static void reset() noexcept
+  {
+    for (auto& op : cnt)
+      for (auto& c : op)
+        c.store(0, memory_order_relaxed);
+  }
+  static void dump_json(ostream& ostr)
+  {
+    ostr << "{";
+    for (int k = 0; k < OP_KIND_COUNT; k++)
+    {
+      const TPerfStats s = stats(TOpKind(k));
+      ostr << (k ? ", " : "") << '"' << TOpAccounting::name(TOpKind(k)) << "\": {\"calls\": "
+        << s.calls << ", \"seconds\": " << s.seconds << ", \"counters\": "
+        << (s.counters ? "true" : "false") << ", \"cycles\": " << s.cycles
+        << ", \"instructions\": " << s.instructions << ", \"cache_misses\": " << s.cache_misses
+        << ", \"llc_misses\": " << s.llc_misses << "}";
+    }
+    ostr << "}";
+  }
+};
+
+// Область замера аппаратных счётчиков (только внешняя операция потока)
+class TPerfScope
+{
+  static inline thread_local int depth = 0;
+  TOpKind kind;
+  uint64_t start_val[PERF_EVENT_COUNT];
+  chrono::steady_clock::time_point start;
+public:
+  explicit TPerfScope(TOpKind k) noexcept : kind(k)
+  {
+    if (depth++ == 0)
+    {
+      TPerfCounters::local().read_all(start_val);
+      start = chrono::steady_clock::now();
+    }
+  }
+  TPerfScope(const TPerfScope&) = delete;
+  TPerfScope& operator=(const TPerfScope&) = delete;
+  ~TPerfScope()
+  {
+    if (--depth == 0)
+    {
+      const auto ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+      const TPerfCounters& pc = TPerfCounters::local();
+      uint64_t val[PERF_EVENT_COUNT];
+      pc.read_all(val);
+      for (int e = 0; e < PERF_EVENT_COUNT; e++)
+        val[e] -= start_val[e];
+      TPerfReport::record(kind, val, uint64_t(ns.count()), pc.available());
+    }
+  }
+};
+
+// Трассировка
+
+struct TTraceEvent
+{
+  const char* name;
+  uint64_t n;       // размер операнда
+  uint64_t ts_ns;   // от момента инициализации трассировщика
+  bool begin;
+};
+
+// Буфер событий одного потока: пишет только владелец, читатель видит
+// опубликованные события [0, count); при переполнении события отбрасываются
+class TTraceBuffer
+{
+  vector<TTraceEvent> events;
+  atomic<size_t> count;
+  atomic<size_t> dropped;
+public:
+  const uint32_t tid;
+
+  TTraceBuffer(size_t capacity, uint32_t tid_) : events(capacity), count(0), dropped(0), tid(tid_) {}
+
+  void push(const TTraceEvent& e) noexcept
+  {
+    const size_t c = count.load(memory_order_relaxed);
+    if (c == events.size())
+    {
+      dropped.fetch_add(1, memory_order_relaxed);
+      return;
+    }
+    events[c] = e;
+    count.store(c + 1, memory_order_release);
+  }
+  size_t size() const noexcept { return count.load(memory_order_acquire); }
+  size_t dropped_count() const noexcept { return dropped.load(memory_order_relaxed); }
+  const TTraceEvent& operator[](size_t i) const noexcept { return events[i]; }
+  void clear() noexcept
+  {
+    count.store(0, memory_order_release);
+    dropped.store(0, memory_order_relaxed);
+  }
+};
+
+class TTracer
+{
+  mutex mtx;
+  vector<shared_ptr<TTraceBuffer>> buffers; // буферы завершившихся потоков сохраняются
+  atomic<bool> enabled;
+  size_t capacity;
+  chrono::steady_clock::time_point origin;
+
+  TTracer() : enabled(true), capacity(size_t(1) << 16), origin(chrono::steady_clock::now()) {}
+
+  TTraceBuffer& local_buffer()
+  {
+    static thread_local shared_ptr<TTraceBuffer> buf;
+    if (!buf)
+    {
+      lock_guard<mutex> lock(mtx);
+      buf = make_shared<TTraceBuffer>(capacity, uint32_t(buffers.size() + 1));
+      buffers.push_back(buf);
+    }
+    return *buf;
+  }
+public:
+  static TTracer& instance()
+  {
+    static TTracer tracer;
+    return tracer;
+  }
+
+  void enable(bool on = true) noexcept { enabled.store(on, memory_order_relaxed); }
+  bool is_enabled() const noexcept { return enabled.load(memory_order_relaxed); }
+  // ёмкость буферов потоков, создаваемых после вызова
+  void set_capacity(size_t events) { lock_guard<mutex> lock(mtx); capacity = events; }
+
+  void record(const char* name, uint64_t n, bool begin) noexcept
+  {
+    if (!is_enabled())
+      return;
+    const auto ts = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - origin);
+    local_buffer().push({ name, n, uint64_t(ts.count()), begin });
+  }
+
+  // очистка; безопасна, когда операции не выполняются
+  void clear()
+  {
+    lock_guard<mutex> lock(mtx);
+    for (auto& b : buffers)
+      b->clear();
+  }
+  size_t dropped()
+  {
+    lock_guard<mutex> lock(mtx);
+    size_t d = 0;
+    for (auto& b : buffers)
+      d += b->dropped_count();
+    return d;
+  }
+
+  void write_json(ostream& ostr)
+  {
+    lock_guard<mutex> lock(mtx);
+    ostr << "{\"traceEvents\": [";
+    bool first = true;
+    char buf[256];
+    for (auto& b : buffers)
+    {
+      const size_t cnt = b->size();
+      for (size_t i = 0; i < cnt; i++)
+      {
+        const TTraceEvent& e = (*b)[i];
+        snprintf(buf, sizeof(buf),
+          "%s\n{\"name\": \"%s\", \"cat\": \"tmatrix\", \"ph\": \"%c\", \"ts\": %.3f, "
+          "\"pid\": 1, \"tid\": %u, \"args\": {\"n\": %llu}}",
+          first ? "" : ",", e.name, e.begin ? 'B' : 'E', double(e.ts_ns) / 1000.0,
+          unsigned(b->tid), (unsigned long long)e.n);
+        ostr << buf;
+        first = false;
+      }
+    }
+    ostr << "\n], \"displayTimeUnit\": \"ns\"}\n";
+  }
+};
+
+class TTraceScope
+{
+  const char* name;
+  uint64_t n;
+public:
+  TTraceScope(const char* name_, uint64_t n_) noexcept : name(name_), n(n_)
+  {
+    TTracer::instance().record(name, n, true);
+  }
+  TTraceScope(const TTraceScope&) = delete;
+  TTraceScope& operator=(const TTraceScope&) = delete;
+  ~TTraceScope()
+  {
+    TTracer::instance().record(name, n, false);
+  }
+};
+
+// точка учёта операции в ядрах векторов и матриц
+#ifdef TMATRIX_ACCOUNTING
+#define TMATRIX_ACCOUNT_SCOPE(kind, flops, rd, wr) \
+  TOpScope tmatrix_op_scope_(kind, uint64_t(flops), uint64_t(rd), uint64_t(wr));
+#else
+#define TMATRIX_ACCOUNT_SCOPE(kind, flops, rd, wr)
+#endif
+#ifdef TMATRIX_PERF_COUNTERS
+#define TMATRIX_PERF_SCOPE(kind) TPerfScope tmatrix_perf_scope_(kind);
+#else
+#define TMATRIX_PERF_SCOPE(kind)
+#endif
+#ifdef TMATRIX_TRACE
+#define TMATRIX_TRACE_SCOPE(kind, n) TTraceScope tmatrix_trace_scope_(TOpAccounting::name(kind), uint64_t(n));
+#else
+#define TMATRIX_TRACE_SCOPE(kind, n)
+#endif
+// n - размер операнда (длина вектора или порядок матрицы)
+#define TMATRIX_OP(kind, n, flops, rd, wr) TMATRIX_TRACE_SCOPE(kind, n) \
+  TMATRIX_ACCOUNT_SCOPE(kind, flops, rd, wr) TMATRIX_PERF_SCOPE(kind) ((void)0)
+
+#endif
@@ -0,0 +1,244 @@
+// ННГУ, ИИТММ, Курс "Алгоритмы и структуры данных"
+//
+// Итерационные методы решения систем линейных уравнений:
+// сопряжённых градиентов (CG) и BiCGStab с предобуславливанием
+//
+// Оператор A - TLinearOperator (toperator.h), плотная TDynamicMatrix, разреженная
+// TSparseMatrix или функция f(x, y), записывающая y = A x. Рабочие векторы выделяются один раз
+// в объекте решателя и переиспользуются между вызовами solve
+//
+
+#ifndef __TSolvers_H__
+#define __TSolvers_H__
+
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+#include "tblas.h"
+#include "tmatrix.h"
+#include "toperator.h"
+#include "tsparse.h"
+
+using namespace std;
+
+// критерий остановки: ||b - A x|| <= tol ||b|| или max_iter итераций
+struct TIterControl
+{
+  double tol = 1e-8;
+  size_t max_iter = 1000;
+};
+
+struct TIterResult
+{
+  size_t iterations;
+  double residual;  // ||b - A x|| / ||b||
+  bool converged;
+};
+
+namespace tmatrix_detail
+{
+  // оператор решателя применяется напрямую, без промежуточного TLinearOperator:
+  // решение не выделяет память ни для какого вида оператора
+  template<typename T>
+  bool is_square_operator(const TLinearOperator<T>& a, size_t n) { return a.rows() == n && a.cols() == n; }
+  template<typename T>
+  bool is_square_operator(const TDynamicMatrix<T>& a, size_t n) { return a.size() == n; }
+  template<typename T>
+  bool is_square_operator(const TSparseMatrix<T>& a, size_t n) { return a.rows() == n && a.cols() == n; }
+  template<typename F>
+  bool is_square_operator(const F&, size_t) { return true; }
+
+  template<typename T>
+  void apply_operator(const TLinearOperator<T>& a, const TDynamicVector<T>& x, TDynamicVector<T>& y)
+  {
+    a.apply(x, y);
+  }
+  template<typename T>
+  void apply_operator(const TDynamicMatrix<T>& a, const TDynamicVector<T>& x, TDynamicVector<T>& y)
+  {
+    gemv(T(1), a, x, T(), y);
+  }
+  template<typename T>
+  void apply_operator(const TSparseMatrix<T>& a, const TDynamicVector<T>& x, TDynamicVector<T>& y)
+  {
+    a.multiply(x, y);
+  }
+  template<typename F, typename T>
+  void apply_operator(const F& f, const TDynamicVector<T>& x, TDynamicVector<T>& y)
+  {
+    f(x, y);
+  }
+}
+
+// Без предобуславливания: z = r
+struct TIdentityPreconditioner
+{
+  template<typename T>
+  void operator()(const TDynamicVector<T>& r, TDynamicVector<T>& z) const { z = r; }
+};
+
+// Предобуславливатель Якоби: z = D^-1 r
+template<typename T>
+class TJacobiPreconditioner
+{
+  TDynamicVector<T> inv_diag;
+
+  void invert()
+  {
+    for (size_t i = 0; i < inv_diag.size(); i++)
+    {
+      if (inv_diag[i] == T())
+        throw invalid_argument("Jacobi preconditioner requires a nonzero diagonal");
+      inv_diag[i] = T(1) / inv_diag[i];
+    }
+  }
+public:
+  explicit TJacobiPreconditioner(const TDynamicVector<T>& diag) : inv_diag(diag) { invert(); }
+  explicit TJacobiPreconditioner(const TDynamicMatrix<T>& a) : inv_diag(a.size())
+  {
+    for (size_t i = 0; i < a.size(); i++)
+      inv_diag[i] = a[i][i];
+    invert();
+  }
+  explicit TJacobiPreconditioner(const TSparseMatrix<T>& a) : inv_diag(a.rows())
+  {
+    for (size_t i = 0; i < a.rows(); i++)
+      inv_diag[i] = a(i, i);
+    invert();
+  }
+
+  void operator()(const TDynamicVector<T>& r, TDynamicVector<T>& z) const
+  {
+    for (size_t i = 0; i < r.size(); i++)
+      z[i] = inv_diag[i] * r[i];
+  }
+};
+
+// Метод сопряжённых градиентов для симметричной положительно определённой A
+template<typename T>
+class TCGSolver
+{
+  static_assert(is_floating_point<T>::value, "TCGSolver requires a floating point element type");
+
+  TDynamicVector<T> r, z, p, q;
+public:
+  explicit TCGSolver(size_t n) : r(n), z(n), p(n), q(n) {}
+
+  size_t size() const noexcept { return r.size(); }
+
+  // x - начальное приближение и результат
+  template<typename Op, typename Prec = TIdentityPreconditioner>
+  TIterResult solve(const Op& a, const TDynamicVector<T>& b, TDynamicVector<T>& x,
+    const Prec& m = Prec(), const TIterControl& ctl = TIterControl())
+  {
+    const size_t n = r.size();
+    if (!tmatrix_detail::is_square_operator(a, n) || b.size() != n || x.size() != n)
+      throw length_error("Operator and vector sizes should match the solver size");
+    const T bnorm = nrm2(b);
+    if (bnorm == T())
+    {
+      fill(&x[0], &x[0] + n, T());
+      return { 0, 0.0, true };
+    }
+
+    tmatrix_detail::apply_operator(a, x, q);
+    r = b;
+    T rr = axpy_dot(T(-1), q, r);
+    m(r, z);
+    p = z;
+    T rz = dot(r, z);
+    size_t it = 0;
+    while (sqrt(rr) > ctl.tol * bnorm && it < ctl.max_iter)
+    {
+      tmatrix_detail::apply_operator(a, p, q);
+      const T pq = dot(p, q);
+      if (pq == T())
+        break;
+      const T alpha = rz / pq;
+      axpy(alpha, p, x);
+      rr = axpy_dot(-alpha, q, r);
+      it++;
+      m(r, z);
+      const T rz_new = dot(r, z);
+      const T beta = rz_new / rz;
+      rz = rz_new;
+      axpby(T(1), z, beta, p);
+    }
+    const double res = double(sqrt(rr) / bnorm);
+    return { it, res, res <= ctl.tol };
+  }
+};
+
+// BiCGStab для несимметричной A, предобуславливание справа
+template<typename T>
+class TBiCGStabSolver
+{
+  static_assert(is_floating_point<T>::value, "TBiCGStabSolver requires a floating point element type");
+
+  TDynamicVector<T> r, r0, p, v, ph, sh, t;
+public:
+  explicit TBiCGStabSolver(size_t n) : r(n), r0(n), p(n), v(n), ph(n), sh(n), t(n) {}
+
+  size_t size() const noexcept { return r.size(); }
+
+  template<typename Op, typename Prec = TIdentityPreconditioner>
+  TIterResult solve(const Op& a, const TDynamicVector<T>& b, TDynamicVector<T>& x,
+    const Prec& m = Prec(), const TIterControl& ctl = TIterControl())
+  {
+    const size_t n = r.size();
+    if (!tmatrix_detail::is_square_operator(a, n) || b.size() != n || x.size() != n)
+      throw length_error("Operator and vector sizes should match the solver size");
+    const T bnorm = nrm2(b);
+    if (bnorm == T())
+    {
+      fill(&x[0], &x[0] + n, T());
+      return { 0, 0.0, true };
+    }
+
+    tmatrix_detail::apply_operator(a, x, t);
+    r = b;
+    T rr = axpy_dot(T(-1), t, r);
+    r0 = r;
+    fill(&p[0], &p[0] + n, T());
+    fill(&v[0], &v[0] + n, T());
+    T rho = 1, alpha = 1, omega = 1;
+    size_t it = 0;
+    while (sqrt(rr) > ctl.tol * bnorm && it < ctl.max_iter)
+    {
+      const T rho_new = dot(r0, r);
+      if (rho_new == T() || omega == T())
+        break; // вырождение метода
+      const T beta = (rho_new / rho) * (alpha / omega);
+      rho = rho_new;
+      // p = r + beta (p - omega v)
+      axpy(-omega, v, p);
+      axpby(T(1), r, beta, p);
+      m(p, ph);
+      tmatrix_detail::apply_operator(a, ph, v);
+      const T r0v = dot(r0, v);
+      if (r0v == T())
+        break;
+      alpha = rho / r0v;
+      it++;
+      // s = r - alpha v хранится на месте r
+      const T ss = axpy_dot(-alpha, v, r);
+      axpy(alpha, ph, x);
+      if (sqrt(ss) <= ctl.tol * bnorm)
+      {
+        rr = ss;
+        break;
+      }
+      m(r, sh);
+      tmatrix_detail::apply_operator(a, sh, t);
+      const T tt = dot(t, t);
+      omega = tt == T() ? T() : dot(t, r) / tt;
+      axpy(omega, sh, x);
+      rr = axpy_dot(-omega, t, r);
+    }
+    const double res = double(sqrt(rr) / bnorm);
+    return { it, res, res <= ctl.tol };
+  }
+};
+
+#endif
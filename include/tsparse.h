@@ -0,0 +1,124 @@
+// ННГУ, ИИТММ, Курс "Алгоритмы и структуры данных"
+//
+// Разреженная матрица в формате CSR
+//
+
+#ifndef __TSparseMatrix_H__
+#define __TSparseMatrix_H__
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "tmatrix.h"
+
+// Разреженная матрица -
+// построчное сжатое хранение (CSR): для строки i ненулевые элементы лежат
+// в val[rowPtr[i]..rowPtr[i+1]) со столбцами colInd[...] по возрастанию
+template<typename T>
+class TSparseMatrix
+{
+protected:
+  size_t nrows, ncols;
+  vector<size_t> rowPtr;
+  vector<size_t> colInd;
+  vector<T> val;
+public:
+  TSparseMatrix(size_t rows = 1, size_t cols = 1) : nrows(rows), ncols(cols), rowPtr(rows + 1, 0)
+  {
+    if (rows == 0 || cols == 0)
+      throw out_of_range("Matrix size should be greater than zero");
+  }
+  // построение из списка (строка, столбец, значение); повторы суммируются
+  TSparseMatrix(size_t rows, size_t cols, const vector<size_t>& ri,
+    const vector<size_t>& ci, const vector<T>& v) : TSparseMatrix(rows, cols)
+  {
+    if (ri.size() != ci.size() || ri.size() != v.size())
+      throw length_error("Triplet arrays should have equal sizes");
+    for (size_t k = 0; k < ri.size(); k++)
+    {
+      if (ri[k] >= nrows || ci[k] >= ncols)
+        throw out_of_range("Matrix index is out of range");
+      rowPtr[ri[k] + 1]++;
+    }
+    partial_sum(rowPtr.begin(), rowPtr.end(), rowPtr.begin());
+    vector<size_t> pos(rowPtr.begin(), rowPtr.end() - 1), order(ri.size());
+    for (size_t k = 0; k < ri.size(); k++)
+      order[pos[ri[k]]++] = k;
+
+    colInd.reserve(ri.size());
+    val.reserve(ri.size());
+    size_t nz = 0;
+    for (size_t i = 0; i < nrows; i++)
+    {
+      const size_t b = rowPtr[i], e = rowPtr[i + 1];
+      sort(order.begin() + b, order.begin() + e,
+        [&ci](size_t x, size_t y) { return ci[x] < ci[y]; });
+      rowPtr[i] = nz;
+      for (size_t k = b; k < e; k++)
+      {
+        if (nz != rowPtr[i] && colInd.back() == ci[order[k]])
+          val.back() += v[order[k]];
+        else
+        {
+          colInd.push_back(ci[order[k]]);
+          val.push_back(v[order[k]]);
+          nz++;
+        }
+      }
+    }
+    rowPtr[nrows] = nz;
+  }
+
+  size_t rows() const noexcept { return nrows; }
+  size_t cols() const noexcept { return ncols; }
+  size_t nnz() const noexcept { return val.size(); }
+
+  const vector<size_t>& row_ptr() const noexcept { return rowPtr; }
+  const vector<size_t>& col_ind() const noexcept { return colInd; }
+  const vector<T>& values() const noexcept { return val; }
+
+  // значение элемента (нуль, если он не хранится)
+  T operator()(size_t i, size_t j) const
+  {
+    if (i >= nrows || j >= ncols)
+      throw out_of_range("Matrix index is out of range");
+    auto b = colInd.begin() + rowPtr[i], e = colInd.begin() + rowPtr[i + 1];
+    auto it = lower_bound(b, e, j);
+    return it != e && *it == j ? val[it - colInd.begin()] : T();
+  }
+
+  // сравнение
+  bool operator==(const TSparseMatrix& m) const
+  {
+    return nrows == m.nrows && ncols == m.ncols && rowPtr == m.rowPtr &&
+      colInd == m.colInd && val == m.val;
+  }
+  bool operator!=(const TSparseMatrix& m) const
+  {
+    return !(*this == m);
+  }
+
+  // матрично-векторные операции
+  // res = A v без выделения памяти
+  void multiply(const TDynamicVector<T>& v, TDynamicVector<T>& res) const
+  {
+    if (ncols != v.size() || nrows != res.size())
+      throw length_error("Matrix and vector sizes are not compatible");
+    for (size_t i = 0; i < nrows; i++)
+    {
+      T s = T();
+      for (size_t k = rowPtr[i]; k < rowPtr[i + 1]; k++)
+        s += val[k] * v[colInd[k]];
+      res[i] = s;
+    }
+  }
+  TDynamicVector<T> operator*(const TDynamicVector<T>& v) const
+  {
+    TDynamicVector<T> res(nrows);
+    multiply(v, res);
+    return res;
+  }
+};
+
+#endif
@@ -0,0 +1,185 @@
+// ННГУ, ИИТММ, Курс "Алгоритмы и структуры данных"
+//
+// Умножение больших квадратных матриц по Штрассену-Винограду
+//
+// 7 умножений и 15 сложений половинных блоков на уровень рекурсии; блоки
+// меньше порога strassen_min (TGemmParams, файл настройки) умножаются блочным
+// gemm_rows. Для вещественных типов погрешность больше, чем у обычного
+// умножения, поэтому путь включается только явным вызовом
+//
+
+#ifndef __TStrassen_H__
+#define __TStrassen_H__
+
+#include <algorithm>
+#include <vector>
+
+#include "tgemm.h"
+#include "tmatrix.h"
+
+using namespace std;
+
+template<typename T>
+class TStrassen
+{
+  // квадратный блок в непрерывной памяти с шагом строк ld
+  struct TView
+  {
+    T* p;
+    size_t ld;
+    T* row(size_t i) const { return p + i * ld; }
+    TView quad(size_t qi, size_t qj, size_t h) const { return { p + qi * h * ld + qj * h, ld }; }
+  };
+
+  vector<T> work;   // X, Y на каждом уровне рекурсии
+  vector<T> a_pad, b_pad, c_pad;
+  size_t crossover;
+
+  // c = a + b, c = a - b
+  static void add(TView c, TView a, TView b, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+    {
+      T* ci = c.row(i);
+      const T* ai = a.row(i);
+      const T* bi = b.row(i);
+      for (size_t j = 0; j < n; j++)
+        ci[j] = ai[j] + bi[j];
+    }
+  }
+  static void sub(TView c, TView a, TView b, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+    {
+      T* ci = c.row(i);
+      const T* ai = a.row(i);
+      const T* bi = b.row(i);
+      for (size_t j = 0; j < n; j++)
+        ci[j] = ai[j] - bi[j];
+    }
+  }
+
+  static void leaf(TView c, TView a, TView b, size_t n)
+  {
+    thread_local vector<const T*> ar, br;
+    thread_local vector<T*> cr;
+    ar.resize(n);
+    br.resize(n);
+    cr.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+      ar[i] = a.row(i);
+      br[i] = b.row(i);
+      cr[i] = c.row(i);
+    }
+    gemm_rows(T(1), ar.data(), br.data(), T(), cr.data(), n, n, n);
+  }
+
+  // c = a b; w - рабочая память уровня и всех нижних
+  void multiply(TView c, TView a, TView b, size_t n, T* w)
+  {
+    if (n <= crossover || n % 2 != 0)
+    {
+      leaf(c, a, b, n);
+      return;
+    }
+    const size_t h = n / 2;
+    const TView a11 = a.quad(0, 0, h), a12 = a.quad(0, 1, h), a21 = a.quad(1, 0, h), a22 = a.quad(1, 1, h);
+    const TView b11 = b.quad(0, 0, h), b12 = b.quad(0, 1, h), b21 = b.quad(1, 0, h), b22 = b.quad(1, 1, h);
+    const TView c11 = c.quad(0, 0, h), c12 = c.quad(0, 1, h), c21 = c.quad(1, 0, h), c22 = c.quad(1, 1, h);
+    const TView x = { w, h }, y = { w + h * h, h };
+    T* next = w + 2 * h * h;
+
+    // порядок с двумя временными блоками (Boyer, Dumas, Pernet, Zhou)
+    sub(x, a11, a21, h);         // S3
+    sub(y, b22, b12, h);         // T3
+    multiply(c21, x, y, h, next); // P7
+    add(x, a21, a22, h);         // S1
+    sub(y, b12, b11, h);         // T1
+    multiply(c22, x, y, h, next); // P5
+    sub(x, x, a11, h);           // S2
+    sub(y, b22, y, h);           // T2
+    multiply(c12, x, y, h, next); // P6
+    sub(x, a12, x, h);           // S4
+    multiply(c11, x, b22, h, next); // P3
+    multiply(x, a11, b11, h, next); // P1
+    add(c12, x, c12, h);         // U2 = P1 + P6
+    add(c21, c12, c21, h);       // U3 = U2 + P7
+    add(c12, c12, c22, h);       // U4 = U2 + P5
+    add(c22, c21, c22, h);       // C22 = U3 + P5
+    add(c12, c12, c11, h);       // C12 = U4 + P3
+    sub(y, y, b21, h);           // T4
+    multiply(c11, a22, y, h, next); // P4
+    sub(c21, c21, c11, h);       // C21 = U3 - P4
+    multiply(c11, a12, b21, h, next); // P2
+    add(c11, x, c11, h);         // C11 = P1 + P2
+  }
+
+  // размер с дополнением нулями: n' = m 2^d, m <= crossover
+  size_t padded_size(size_t n) const
+  {
+    size_t m = n, levels = 0;
+    while (m > crossover)
+    {
+      m = (m + 1) / 2;
+      levels++;
+    }
+    return m << levels;
+  }
+
+  static size_t work_size(size_t n, size_t crossover)
+  {
+    size_t total = 0;
+    for (; n > crossover && n % 2 == 0; n /= 2)
+      total += 2 * (n / 2) * (n / 2);
+    return total;
+  }
+public:
+  // crossover - наибольший размер блока, умножаемого без рекурсии
+  explicit TStrassen(size_t crossover_ = gemm_params().strassen_min) : crossover(max<size_t>(crossover_, 1)) {}
+
+  // рабочая память выделяется при первом умножении данного размера
+  // и переиспользуется последующими
+  void multiply(const TDynamicMatrix<T>& a, const TDynamicMatrix<T>& b, TDynamicMatrix<T>& c)
+  {
+    const size_t n = a.size();
+    if (b.size() != n || c.size() != n)
+      throw length_error("Matrix sizes should be equal");
+    const size_t np = padded_size(n);
+    const size_t ld = np + 8; // шаг строк не степень двойки: меньше конфликтов в кэше
+    if (work.size() < work_size(np, crossover))
+      work.resize(work_size(np, crossover));
+    if (a_pad.size() < np * ld)
+    {
+      a_pad.resize(np * ld);
+      b_pad.resize(np * ld);
+      c_pad.resize(np * ld);
+    }
+    for (size_t i = 0; i < np; i++)
+      for (size_t j = 0; j < np; j++)
+      {
+        const bool in = i < n && j < n;
+        a_pad[i * ld + j] = in ? a[i][j] : T();
+        b_pad[i * ld + j] = in ? b[i][j] : T();
+      }
+    multiply(TView{ c_pad.data(), ld }, TView{ a_pad.data(), ld }, TView{ b_pad.data(), ld }, np, work.data());
+    for (size_t i = 0; i < n; i++)
+      copy(&c_pad[i * ld], &c_pad[i * ld] + n, &c[i][0]);
+  }
+
+  TDynamicMatrix<T> multiply(const TDynamicMatrix<T>& a, const TDynamicMatrix<T>& b)
+  {
+    TDynamicMatrix<T> c(a.size());
+    multiply(a, b, c);
+    return c;
+  }
+};
+
+// A B по Штрассену-Винограду с порогом из gemm_params()
+template<typename T>
+TDynamicMatrix<T> strassen(const TDynamicMatrix<T>& a, const TDynamicMatrix<T>& b)
+{
+  return TStrassen<T>().multiply(a, b);
+}
+
+#endif
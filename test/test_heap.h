@@ -0,0 +1,11 @@
+#ifndef __TestHeap_H__
+#define __TestHeap_H__
+
+#include <cstddef>
+
+using namespace std;
+
+// число выделений памяти через operator new в текущем потоке (test_main.cpp)
+size_t heap_allocations() noexcept;
+
+#endif
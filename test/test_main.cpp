@@ -1,5 +1,28 @@
+#include <cstdlib>
+#include <new>
+
 #include <gtest.h>
 
+#include "test_heap.h"
+
+namespace
+{
+  thread_local size_t heap_count = 0;
+}
+
+// счётчик выделений памяти для тестов "не выделяет память"
+void* operator new(size_t n)
+{
+  heap_count++;
+  if (void* p = malloc(n == 0 ? 1 : n))
+    return p;
+  throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+size_t heap_allocations() noexcept { return heap_count; }
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,223 @@
+#include "tblas.h"
+
+#include <gtest.h>
+
+#include "test_heap.h"
+
+namespace
+{
+  struct TIsaGuard
+  {
+    TIsaLevel saved = current_isa();
+    ~TIsaGuard() { select_isa(saved); }
+  };
+
+  TDynamicVector<double> make_vector(size_t n, size_t seed)
+  {
+    TDynamicVector<double> v(n);
+    for (size_t i = 0; i < n; i++)
+      v[i] = double((i * 5 + seed) % 9) / 4.0 - 1.0;
+    return v;
+  }
+}
+
+TEST(TBlas, axpy_matches_vector_operators)
+{
+  const TDynamicVector<double> x = make_vector(37, 1);
+  TDynamicVector<double> y = make_vector(37, 2);
+  const TDynamicVector<double> expected = y + x * 0.5;
+
+  axpy(0.5, x, y);
+  EXPECT_EQ(expected, y);
+}
+
+TEST(TBlas, axpby_matches_vector_operators)
+{
+  const TDynamicVector<double> x = make_vector(37, 3);
+  TDynamicVector<double> y = make_vector(37, 4);
+  const TDynamicVector<double> expected = x * 2.0 + y * -0.25;
+
+  axpby(2.0, x, -0.25, y);
+  EXPECT_EQ(expected, y);
+}
+
+TEST(TBlas, scal_and_nrm2)
+{
+  TDynamicVector<double> x(4);
+  x[0] = 3.0; x[1] = 0.0; x[2] = -4.0; x[3] = 0.0;
+
+  EXPECT_EQ(5.0, nrm2(x));
+  scal(2.0, x);
+  EXPECT_EQ(-8.0, x[2]);
+  EXPECT_EQ(10.0, nrm2(x));
+}
+
+TEST(TBlas, dot_matches_operator)
+{
+  const TDynamicVector<double> x = make_vector(41, 5), y = make_vector(41, 6);
+
+  EXPECT_EQ(x * y, dot(x, y));
+}
+
+TEST(TBlas, axpy_dot_returns_squared_norm_of_result)
+{
+  for (size_t n : { 1, 3, 4, 37 })
+  {
+    const TDynamicVector<double> x = make_vector(n, 7);
+    TDynamicVector<double> y = make_vector(n, 8);
+    const TDynamicVector<double> expected = y - x * 0.5;
+
+    const double yy = axpy_dot(-0.5, x, y);
+    EXPECT_EQ(expected, y);
+    EXPECT_DOUBLE_EQ(expected * expected, yy);
+  }
+}
+
+TEST(TBlas, every_isa_gives_same_results_as_scalar)
+{
+  TIsaGuard guard;
+  const TDynamicVector<double> x = make_vector(37, 9);
+  const TDynamicVector<double> y0 = make_vector(37, 10);
+
+  select_isa(ISA_SCALAR);
+  TDynamicVector<double> ya = y0, yb = y0, yd = y0;
+  axpy(0.75, x, ya);
+  axpby(0.5, x, -2.0, yb);
+  const double dd = axpy_dot(-0.25, x, yd);
+
+  for (int k = ISA_SSE42; k <= int(detect_isa()); k++)
+  {
+    select_isa(TIsaLevel(k));
+    SCOPED_TRACE(isa_name(TIsaLevel(k)));
+    // значения точно представимы, поэтому FMA не влияет на результат
+    TDynamicVector<double> za = y0, zb = y0, zd = y0;
+    axpy(0.75, x, za);
+    axpby(0.5, x, -2.0, zb);
+    EXPECT_EQ(ya, za);
+    EXPECT_EQ(yb, zb);
+    EXPECT_EQ(dd, axpy_dot(-0.25, x, zd));
+    EXPECT_EQ(yd, zd);
+  }
+}
+
+TEST(TBlas, throws_when_sizes_are_not_equal)
+{
+  const TDynamicVector<double> x(3);
+  TDynamicVector<double> y(4);
+
+  ASSERT_ANY_THROW(axpy(1.0, x, y));
+  ASSERT_ANY_THROW(axpby(1.0, x, 1.0, y));
+  ASSERT_ANY_THROW(dot(x, y));
+  ASSERT_ANY_THROW(axpy_dot(1.0, x, y));
+}
+
+TEST(TBlas, does_not_allocate_memory)
+{
+  const TDynamicVector<double> x = make_vector(64, 11);
+  TDynamicVector<double> y = make_vector(64, 12);
+  const size_t before = heap_allocations();
+
+  axpy(0.5, x, y);
+  axpby(0.5, x, 0.5, y);
+  scal(0.5, y);
+  (void)dot(x, y);
+  (void)nrm2(y);
+  (void)axpy_dot(0.5, x, y);
+  EXPECT_EQ(before, heap_allocations());
+}
+
+TEST(TBlas, gemv_accumulates_scaled_product)
+{
+  const size_t n = 23;
+  TDynamicMatrix<double> a(n);
+  for (size_t i = 0; i < n; i++)
+    a[i] = make_vector(n, i);
+  const TDynamicVector<double> x = make_vector(n, 13);
+  TDynamicVector<double> y = make_vector(n, 14);
+  const TDynamicVector<double> expected = (a * x) * 2.0 + y * 0.5;
+
+  gemv(2.0, a, x, 0.5, y);
+  EXPECT_EQ(expected, y);
+}
+
+TEST(TBlas, gemv_with_zero_beta_ignores_previous_result)
+{
+  const size_t n = 9;
+  TDynamicMatrix<double> a(n);
+  for (size_t i = 0; i < n; i++)
+    a[i] = make_vector(n, i + 1);
+  const TDynamicVector<double> x = make_vector(n, 15);
+  TDynamicVector<double> y(n);
+  for (size_t i = 0; i < n; i++)
+    y[i] = nan("");
+
+  gemv(1.0, a, x, 0.0, y);
+  EXPECT_EQ(a * x, y);
+}
+
+TEST(TBlas, gemm_accumulates_scaled_product)
+{
+  // больше блоков по всем измерениям и порога распараллеливания
+  for (size_t n : { 5, 130 })
+  {
+    TDynamicMatrix<double> a(n), b(n), c(n);
+    for (size_t i = 0; i < n; i++)
+    {
+      a[i] = make_vector(n, i);
+      b[i] = make_vector(n, 2 * i + 1);
+      c[i] = make_vector(n, 3 * i + 2);
+    }
+    const TDynamicMatrix<double> expected = (a * b) * -0.5 + c * 2.0;
+
+    gemm(-0.5, a, b, 2.0, c);
+    EXPECT_EQ(expected, c);
+  }
+}
+
+TEST(TBlas, gemm_with_zero_beta_ignores_previous_result)
+{
+  const size_t n = 17;
+  TDynamicMatrix<double> a(n), b(n), c(n);
+  for (size_t i = 0; i < n; i++)
+  {
+    a[i] = make_vector(n, i);
+    b[i] = make_vector(n, i + 5);
+    for (size_t j = 0; j < n; j++)
+      c[i][j] = nan("");
+  }
+
+  gemm(1.0, a, b, 0.0, c);
+  EXPECT_EQ(a * b, c);
+}
+
+TEST(TBlas, gemm_and_gemv_do_not_allocate_memory)
+{
+  const size_t n = 32;
+  TDynamicMatrix<double> a(n), b(n), c(n);
+  for (size_t i = 0; i < n; i++)
+  {
+    a[i] = make_vector(n, i);
+    b[i] = make_vector(n, i + 1);
+  }
+  TDynamicVector<double> x = make_vector(n, 3), y(n);
+  gemm(1.0, a, b, 1.0, c); // буферы блоков потока выделяются при первом вызове
+  const size_t before = heap_allocations();
+
+  for (int k = 0; k < 3; k++)
+  {
+    gemm(1.0, a, b, 1.0, c);
+    gemv(1.0, a, x, 1.0, y);
+  }
+  EXPECT_EQ(before, heap_allocations());
+}
+
+TEST(TBlas, gemm_and_gemv_throw_on_bad_arguments)
+{
+  TDynamicMatrix<double> a(3), b(3), c(4);
+  TDynamicVector<double> x(3), y(4);
+
+  ASSERT_ANY_THROW(gemm(1.0, a, b, 0.0, c));
+  ASSERT_ANY_THROW(gemm(1.0, a, b, 0.0, a));
+  ASSERT_ANY_THROW(gemv(1.0, a, x, 0.0, y));
+  ASSERT_ANY_THROW(gemv(1.0, a, x, 0.0, x));
+}
@@ -0,0 +1,217 @@
+#include "tgemm.h"
+#include "tmatrix.h"
+
+#include <gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "test_heap.h"
+
+namespace
+{
+  // восстанавливает параметры умножения после теста
+  struct TParamsGuard
+  {
+    TGemmParams saved = gemm_params();
+    ~TParamsGuard() { set_gemm_params(saved); }
+  };
+
+  TDynamicMatrix<int> make_matrix(size_t n, int seed)
+  {
+    TDynamicMatrix<int> m(n);
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < n; j++)
+        m[i][j] = int((i * 5 + j * 3 + size_t(seed)) % 7) - 3;
+    return m;
+  }
+
+  TDynamicMatrix<int> naive_mul(const TDynamicMatrix<int>& a, const TDynamicMatrix<int>& b)
+  {
+    const size_t n = a.size();
+    TDynamicMatrix<int> c(n);
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < n; j++)
+        for (size_t k = 0; k < n; k++)
+          c[i][j] += a[i][k] * b[k][j];
+    return c;
+  }
+}
+
+TEST(TGemm, can_write_and_read_params)
+{
+  TGemmParams p;
+  p.block_m = 24; p.block_k = 96; p.block_n = 200; p.par_min_gemm = 150; p.par_min_gemv = 700;
+  p.strassen_min = 300;
+  stringstream s;
+  write_gemm_params(s, p);
+
+  EXPECT_EQ(p, read_gemm_params(s));
+}
+
+TEST(TGemm, read_skips_comments_and_unknown_keys)
+{
+  istringstream s("# comment\n\nblock_m = 8  # rows\nfuture_key = 3\n");
+  TGemmParams p = read_gemm_params(s);
+
+  EXPECT_EQ(8, p.block_m);
+  EXPECT_EQ(TGemmParams().block_k, p.block_k);
+}
+
+TEST(TGemm, read_throws_on_bad_value)
+{
+  istringstream zero("block_k = 0\n"), text("block_k = many\n"), no_eq("block_k 4\n");
+
+  ASSERT_ANY_THROW(read_gemm_params(zero));
+  ASSERT_ANY_THROW(read_gemm_params(text));
+  ASSERT_ANY_THROW(read_gemm_params(no_eq));
+}
+
+TEST(TGemm, set_params_throws_on_zero_block)
+{
+  TGemmParams p;
+  p.block_n = 0;
+
+  ASSERT_ANY_THROW(set_gemm_params(p));
+}
+
+TEST(TGemm, can_load_params_from_file)
+{
+  TParamsGuard guard;
+  const string path = "test_tgemm_params.cfg";
+  {
+    ofstream f(path);
+    f << "block_m = 12\nblock_k = 40\n";
+  }
+  load_gemm_params(path);
+  remove(path.c_str());
+
+  EXPECT_EQ(12, gemm_params().block_m);
+  EXPECT_EQ(40, gemm_params().block_k);
+  ASSERT_ANY_THROW(load_gemm_params("test_tgemm_missing.cfg"));
+}
+
+TEST(TGemm, startup_params_ignore_file_in_current_directory)
+{
+  const string path = "tmatrix_tuning.cfg";
+  if (getenv("TMATRIX_TUNING_FILE") != nullptr || ifstream(path))
+    return; // не трогаем настройку пользователя
+  {
+    ofstream f(path);
+    f << "block_m = 7\n";
+  }
+  const TGemmParams p = tmatrix_detail::load_startup_params();
+  remove(path.c_str());
+
+  EXPECT_EQ(TGemmParams(), p);
+}
+
+TEST(TGemm, params_can_change_during_multiplication)
+{
+  TParamsGuard guard;
+  const TDynamicMatrix<int> a = make_matrix(40, 6), b = make_matrix(40, 7), expected = naive_mul(a, b);
+  thread tuner([] {
+    for (size_t k = 0; k < 200; k++)
+    {
+      TGemmParams p;
+      p.block_m = 1 + k % 8; p.block_k = 1 + k % 5; p.block_n = 1 + k % 7;
+      set_gemm_params(p);
+    }
+  });
+  for (int k = 0; k < 20; k++)
+    EXPECT_EQ(expected, a * b);
+  tuner.join();
+}
+
+TEST(TGemm, blocked_multiply_matches_naive_for_partial_blocks)
+{
+  TParamsGuard guard;
+  TGemmParams p;
+  p.block_m = 3; p.block_k = 5; p.block_n = 4;
+  const TDynamicMatrix<int> a = make_matrix(13, 1), b = make_matrix(13, 2), expected = naive_mul(a, b);
+
+  p.par_min_gemm = 1000;
+  set_gemm_params(p);
+  EXPECT_EQ(expected, a * b);
+  p.par_min_gemm = 1;
+  set_gemm_params(p);
+  EXPECT_EQ(expected, a * b);
+}
+
+TEST(TGemm, parallel_matvec_matches_sequential)
+{
+  TParamsGuard guard;
+  const TDynamicMatrix<int> a = make_matrix(150, 3);
+  const TDynamicVector<int> x = a[7];
+  TGemmParams p;
+  p.par_min_gemv = 1000;
+  set_gemm_params(p);
+  const TDynamicVector<int> expected = a * x;
+  p.par_min_gemv = 1;
+  set_gemm_params(p);
+
+  EXPECT_EQ(expected, a * x);
+}
+
+TEST(TGemm, autotune_returns_positive_blocks)
+{
+  TParamsGuard guard;
+  const TGemmParams p = autotune_gemm(32, 1);
+
+  EXPECT_GT(p.block_m, 0);
+  EXPECT_GT(p.block_k, 0);
+  EXPECT_GT(p.block_n, 0);
+  EXPECT_EQ(guard.saved, gemm_params()); // подбор не меняет текущие параметры
+}
+
+TEST(TGemm, recursive_multiply_matches_naive)
+{
+  const TDynamicMatrix<int> a = make_matrix(75, 4), b = make_matrix(75, 5);
+
+  EXPECT_EQ(naive_mul(a, b), multiply_recursive(a, b));
+}
+
+TEST(TGemm, recursive_rows_handle_rectangular_shapes)
+{
+  // A (70 x 3), B (3 x 45), C += A B поверх ненулевого C
+  const size_t m = 70, k = 3, n = 45;
+  vector<int> a(m * k), b(k * n), c(m * n, 1), expected(m * n, 1);
+  for (size_t i = 0; i < a.size(); i++)
+    a[i] = int(i % 5) - 2;
+  for (size_t i = 0; i < b.size(); i++)
+    b[i] = int(i % 7) - 3;
+  for (size_t i = 0; i < m; i++)
+    for (size_t j = 0; j < n; j++)
+      for (size_t l = 0; l < k; l++)
+        expected[i * n + j] += a[i * k + l] * b[l * n + j];
+  vector<const int*> ar(m), br(k);
+  vector<int*> cr(m);
+  for (size_t i = 0; i < m; i++)
+  {
+    ar[i] = &a[i * k];
+    cr[i] = &c[i * n];
+  }
+  for (size_t l = 0; l < k; l++)
+    br[l] = &b[l * n];
+  gemm_recursive_rows(ar.data(), br.data(), cr.data(), m, k, n);
+
+  EXPECT_EQ(expected, c);
+}
+
+TEST(TGemm, recursive_rows_accept_matrices_without_allocation)
+{
+  const size_t n = 40;
+  const TDynamicMatrix<int> a = make_matrix(n, 1), b = make_matrix(n, 2);
+  TDynamicMatrix<int> c(n);
+  const size_t before = heap_allocations();
+  gemm_recursive_rows(a, b, c, n, n, n);
+
+  EXPECT_EQ(before, heap_allocations());
+  EXPECT_EQ(naive_mul(a, b), c);
+}
+
+TEST(TGemm, recursive_multiply_throws_when_sizes_differ)
+{
+  ASSERT_ANY_THROW(multiply_recursive(TDynamicMatrix<int>(3), TDynamicMatrix<int>(4)));
+}
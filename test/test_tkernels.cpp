@@ -0,0 +1,84 @@
+#include "tkernels.h"
+#include "tmatrix.h"
+
+#include <gtest.h>
+
+namespace
+{
+  // восстанавливает исходный набор инструкций после теста
+  struct TIsaGuard
+  {
+    TIsaLevel saved = current_isa();
+    ~TIsaGuard() { select_isa(saved); }
+  };
+
+  TDynamicMatrix<double> make_matrix(size_t n, double seed)
+  {
+    TDynamicMatrix<double> m(n);
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < n; j++)
+        m[i][j] = seed + double((i * 7 + j * 3) % 11) / 4.0;
+    return m;
+  }
+}
+
+TEST(TKernels, detected_isa_is_valid)
+{
+  EXPECT_LT(int(detect_isa()), int(ISA_LEVEL_COUNT));
+  EXPECT_LE(int(current_isa()), int(detect_isa()));
+}
+
+TEST(TKernels, select_isa_is_clamped_to_detected)
+{
+  TIsaGuard guard;
+  EXPECT_EQ(ISA_SCALAR, select_isa(ISA_SCALAR));
+  EXPECT_EQ(ISA_SCALAR, current_isa());
+  EXPECT_EQ(detect_isa(), select_isa(ISA_AVX512));
+}
+
+TEST(TKernels, every_isa_gives_same_results_as_scalar)
+{
+  TIsaGuard guard;
+  const size_t n = 37; // не кратно ширине векторных регистров
+  TDynamicMatrix<double> a = make_matrix(n, 1.0), b = make_matrix(n, -2.0);
+  TDynamicVector<double> x = a[3], y = b[5];
+
+  select_isa(ISA_SCALAR);
+  const TDynamicMatrix<double> mul = a * b, sum = a + b, diff = a - b, scaled = a * 0.5;
+  const TDynamicVector<double> mv = a * x, vs = x + y, vd = x - y, vsc = x * 0.25;
+  const double dot = x * y;
+
+  for (int k = ISA_SSE42; k <= int(detect_isa()); k++)
+  {
+    select_isa(TIsaLevel(k));
+    SCOPED_TRACE(isa_name(TIsaLevel(k)));
+    // значения точно представимы, поэтому порядок сложения и FMA не влияют на результат
+    EXPECT_EQ(mul, a * b);
+    EXPECT_EQ(sum, a + b);
+    EXPECT_EQ(diff, a - b);
+    EXPECT_EQ(scaled, a * 0.5);
+    EXPECT_EQ(mv, a * x);
+    EXPECT_EQ(vs, x + y);
+    EXPECT_EQ(vd, x - y);
+    EXPECT_EQ(vsc, x * 0.25);
+    EXPECT_EQ(dot, x * y);
+  }
+}
+
+TEST(TKernels, integer_kernels_match_scalar)
+{
+  TIsaGuard guard;
+  TDynamicVector<int> a(19), b(19);
+  for (size_t i = 0; i < 19; i++)
+  {
+    a[i] = int(i) - 7;
+    b[i] = 3 * int(i) + 1;
+  }
+  select_isa(ISA_SCALAR);
+  const int dot = a * b;
+  for (int k = ISA_SSE42; k <= int(detect_isa()); k++)
+  {
+    select_isa(TIsaLevel(k));
+    EXPECT_EQ(dot, a * b);
+  }
+}
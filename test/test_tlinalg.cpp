@@ -0,0 +1,438 @@
+#include "tlinalg.h"
+
+#include <gtest.h>
+
+#include "test_heap.h"
+
+namespace
+{
+  // несимметричная матрица с нулём на диагонали, требует перестановок
+  TDynamicMatrix<double> make_matrix(size_t n)
+  {
+    TDynamicMatrix<double> m(n);
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < n; j++)
+        m[i][j] = double((i * 7 + j * 13) % 17) - 8.0 + (i == j ? 20.0 : 0.0);
+    m[0][0] = 0.0;
+    return m;
+  }
+
+  double max_residual(const TDynamicMatrix<double>& a, const TDynamicVector<double>& x, const TDynamicVector<double>& b)
+  {
+    const TDynamicVector<double> r = a * x - b;
+    double res = 0;
+    for (size_t i = 0; i < r.size(); i++)
+      res = max(res, abs(r[i]));
+    return res;
+  }
+}
+
+TEST(TLU, can_solve_small_system_with_pivoting)
+{
+  TDynamicMatrix<double> a(2);
+  a[0][0] = 0; a[0][1] = 2;
+  a[1][0] = 3; a[1][1] = 1;
+  TDynamicVector<double> b(2);
+  b[0] = 4; b[1] = 5;
+  TDynamicVector<double> x = solve(a, b);
+
+  EXPECT_DOUBLE_EQ(1.0, x[0]);
+  EXPECT_DOUBLE_EQ(2.0, x[1]);
+}
+
+TEST(TLU, determinant_accounts_for_row_swaps)
+{
+  TDynamicMatrix<double> a(3);
+  a[0][0] = 0; a[0][1] = 1; a[0][2] = 0;
+  a[1][0] = 1; a[1][1] = 0; a[1][2] = 0;
+  a[2][0] = 0; a[2][1] = 0; a[2][2] = 5;
+
+  EXPECT_DOUBLE_EQ(-5.0, det(a));
+}
+
+TEST(TLU, blocked_factorization_reconstructs_matrix)
+{
+  const size_t n = 37;
+  const TDynamicMatrix<double> a = make_matrix(n);
+  TLU<double> lu(a, 8); // неполный последний блок
+  const TDynamicMatrix<double>& f = lu.factors();
+  TDynamicMatrix<double> pa(a);
+  lu.permutation().apply(pa);
+  for (size_t i = 0; i < n; i++)
+    for (size_t j = 0; j < n; j++)
+    {
+      double s = 0;
+      for (size_t k = 0; k <= min(i, j); k++)
+        s += (k == i ? 1.0 : f[i][k]) * f[k][j];
+      EXPECT_NEAR(pa[i][j], s, 1e-9);
+    }
+}
+
+TEST(TLU, block_size_does_not_change_solution)
+{
+  const size_t n = 50;
+  const TDynamicMatrix<double> a = make_matrix(n);
+  TDynamicVector<double> b(n);
+  for (size_t i = 0; i < n; i++)
+    b[i] = double(i % 5) - 2.0;
+  const TDynamicVector<double> x1 = TLU<double>(a, 1).solve(b), x16 = TLU<double>(a, 16).solve(b);
+
+  EXPECT_LT(max_residual(a, x1, b), 1e-9);
+  EXPECT_LT(max_residual(a, x16, b), 1e-9);
+  EXPECT_NEAR(TLU<double>(a, 1).det() / TLU<double>(a, 16).det(), 1.0, 1e-9);
+}
+
+TEST(TLU, can_solve_multiple_right_hand_sides)
+{
+  const size_t n = 20;
+  const TDynamicMatrix<double> a = make_matrix(n);
+  TDynamicMatrix<double> b(n);
+  for (size_t i = 0; i < n; i++)
+    for (size_t j = 0; j < n; j++)
+      b[i][j] = double((i + 3 * j) % 7);
+  const TDynamicMatrix<double> x = solve(a, b), ax = a * x;
+
+  for (size_t i = 0; i < n; i++)
+    for (size_t j = 0; j < n; j++)
+      EXPECT_NEAR(b[i][j], ax[i][j], 1e-9);
+}
+
+TEST(TLU, singular_matrix_has_zero_determinant_and_cant_be_solved)
+{
+  TDynamicMatrix<double> a(3);
+  for (size_t i = 0; i < 3; i++)
+    for (size_t j = 0; j < 3; j++)
+      a[i][j] = double(i + j);
+  TLU<double> lu(a);
+
+  EXPECT_TRUE(lu.is_singular());
+  EXPECT_EQ(0.0, lu.det());
+  ASSERT_ANY_THROW(lu.solve(TDynamicVector<double>(3)));
+}
+
+TEST(TLU, throws_when_right_hand_side_size_differs)
+{
+  TLU<double> lu(make_matrix(4));
+
+  ASSERT_ANY_THROW(lu.solve(TDynamicVector<double>(5)));
+}
+
+namespace
+{
+  // A = B B^T + n I
+  TDynamicMatrix<double> make_spd(size_t n)
+  {
+    TDynamicMatrix<double> b = make_matrix(n), a(n);
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < n; j++)
+      {
+        double s = i == j ? double(n) : 0.0;
+        for (size_t k = 0; k < n; k++)
+          s += b[i][k] * b[j][k];
+        a[i][j] = s;
+      }
+    return a;
+  }
+}
+
+TEST(TCholesky, blocked_factorization_reconstructs_matrix)
+{
+  const size_t n = 45;
+  const TDynamicMatrix<double> a = make_spd(n);
+  const TCholesky<double> ch(a, 8);
+  const TDynamicMatrix<double>& l = ch.factors();
+
+  for (size_t i = 0; i < n; i++)
+    for (size_t j = 0; j < n; j++)
+    {
+      double s = 0;
+      for (size_t k = 0; k < n; k++)
+        s += l[i][k] * l[j][k];
+      EXPECT_NEAR(a[i][j], s, 1e-8 * a[i][i]);
+      if (j > i)
+      {
+        EXPECT_EQ(0.0, l[i][j]);
+      }
+    }
+}
+
+TEST(TCholesky, reads_only_lower_triangle)
+{
+  const size_t n = 20;
+  TDynamicMatrix<double> a = make_spd(n), lower(a);
+  for (size_t i = 0; i < n; i++)
+    for (size_t j = i + 1; j < n; j++)
+      lower[i][j] = -1e300;
+
+  EXPECT_EQ(TCholesky<double>(a, 4).factors(), TCholesky<double>(lower, 4).factors());
+}
+
+TEST(TCholesky, solve_and_logdet_agree_with_lu)
+{
+  const size_t n = 30;
+  const TDynamicMatrix<double> a = make_spd(n);
+  TDynamicVector<double> b(n);
+  for (size_t i = 0; i < n; i++)
+    b[i] = double(i % 4) + 1.0;
+  const TCholesky<double> ch(a, 7);
+  const TLU<double> lu(a);
+
+  EXPECT_LT(max_residual(a, ch.solve(b), b), 1e-9);
+  EXPECT_NEAR(log(lu.det()), ch.logdet(), 1e-9);
+}
+
+TEST(TCholesky, can_solve_multiple_right_hand_sides)
+{
+  const size_t n = 16;
+  const TDynamicMatrix<double> a = make_spd(n);
+  TDynamicMatrix<double> b(n);
+  for (size_t i = 0; i < n; i++)
+    b[i][i] = 1.0;
+  const TDynamicMatrix<double> ax = a * TCholesky<double>(a, 5).solve(b);
+
+  for (size_t i = 0; i < n; i++)
+    for (size_t j = 0; j < n; j++)
+      EXPECT_NEAR(i == j ? 1.0 : 0.0, ax[i][j], 1e-9);
+}
+
+TEST(TCholesky, throws_when_matrix_is_not_positive_definite)
+{
+  TDynamicMatrix<double> a(2);
+  a[0][0] = 1; a[1][0] = 2; a[1][1] = 1;
+
+  ASSERT_ANY_THROW(TCholesky<double> ch(a));
+}
+
+namespace
+{
+  // треугольная часть make_matrix с усиленной диагональю
+  TDynamicMatrix<double> make_triangle(size_t n, TTriangle uplo)
+  {
+    TDynamicMatrix<double> a = make_matrix(n);
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < n; j++)
+        if (uplo == TRI_LOWER ? j > i : j < i)
+          a[i][j] = 1e300; // вне треугольника не читается
+        else if (i == j)
+          a[i][j] = double(n);
+    return a;
+  }
+
+  // op(A) x с учётом треугольника и единичной диагонали
+  TDynamicVector<double> tri_mul(const TDynamicMatrix<double>& a, const TDynamicVector<double>& x,
+    TTriangle uplo, TTranspose trans, TDiagonal diag)
+  {
+    const size_t n = a.size();
+    TDynamicVector<double> y(n);
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < n; j++)
+      {
+        const size_t r = trans == TRANS ? j : i, c = trans == TRANS ? i : j;
+        if (uplo == TRI_LOWER ? c > r : c < r)
+          continue;
+        y[i] += (r == c && diag == UNIT_DIAG ? 1.0 : a[r][c]) * x[j];
+      }
+    return y;
+  }
+}
+
+TEST(TTriangular, trsv_solves_all_variants)
+{
+  const size_t n = 23;
+  TDynamicVector<double> b(n);
+  for (size_t i = 0; i < n; i++)
+    b[i] = double(i % 6) - 2.5;
+  for (TTriangle uplo : { TRI_LOWER, TRI_UPPER })
+    for (TTranspose trans : { NO_TRANS, TRANS })
+      for (TDiagonal diag : { NON_UNIT_DIAG, UNIT_DIAG })
+      {
+        const TDynamicMatrix<double> a = make_triangle(n, uplo);
+        TDynamicVector<double> x(b);
+        trsv(a, x, uplo, trans, diag);
+        const TDynamicVector<double> ax = tri_mul(a, x, uplo, trans, diag);
+        for (size_t i = 0; i < n; i++)
+          EXPECT_NEAR(b[i], ax[i], 1e-8) << uplo << trans << diag;
+      }
+}
+
+TEST(TTriangular, blocked_trsm_matches_trsv_per_column)
+{
+  const size_t n = 70; // больше ширины полосы и блока
+  TDynamicMatrix<double> b(n);
+  for (size_t i = 0; i < n; i++)
+    for (size_t j = 0; j < n; j++)
+      b[i][j] = double((i * 3 + j) % 9) - 4.0;
+  for (TTriangle uplo : { TRI_LOWER, TRI_UPPER })
+    for (TTranspose trans : { NO_TRANS, TRANS })
+    {
+      const TDynamicMatrix<double> a = make_triangle(n, uplo);
+      TDynamicMatrix<double> x(b);
+      trsm(a, x, uplo, trans);
+      for (size_t j = 0; j < n; j += 13)
+      {
+        TDynamicVector<double> col(n);
+        for (size_t i = 0; i < n; i++)
+          col[i] = b[i][j];
+        trsv(a, col, uplo, trans);
+        for (size_t i = 0; i < n; i++)
+          EXPECT_NEAR(col[i], x[i][j], 1e-12) << uplo << trans;
+      }
+    }
+}
+
+TEST(TTriangular, throws_when_right_hand_side_size_differs)
+{
+  const TDynamicMatrix<double> a = make_triangle(3, TRI_LOWER);
+  TDynamicVector<double> x(4);
+  TDynamicMatrix<double> b(4);
+
+  ASSERT_ANY_THROW(trsv(a, x, TRI_LOWER));
+  ASSERT_ANY_THROW(trsm(a, b, TRI_LOWER));
+}
+
+namespace
+{
+  // m строк длины n
+  TDynamicVector<TDynamicVector<double>> make_tall(size_t m, size_t n)
+  {
+    TDynamicVector<TDynamicVector<double>> a(m);
+    for (size_t i = 0; i < m; i++)
+    {
+      a[i] = TDynamicVector<double>(n);
+      for (size_t j = 0; j < n; j++)
+        a[i][j] = double((i * 5 + j * 11) % 13) - 6.0 + (i == j ? 10.0 : 0.0);
+    }
+    return a;
+  }
+}
+
+TEST(TQR, blocked_factorization_reconstructs_matrix)
+{
+  const size_t m = 41, n = 29;
+  const TDynamicVector<TDynamicVector<double>> a = make_tall(m, n);
+  const TQR<double> qr(a, 6);
+  const TDynamicMatrix<double> r = qr.r();
+  // Q R по столбцам: Q (R e_j) = A e_j
+  for (size_t j = 0; j < n; j++)
+  {
+    TDynamicVector<double> col(m);
+    for (size_t i = 0; i < n; i++)
+      col[i] = r[i][j];
+    TDynamicVector<double> qtcol(m);
+    for (size_t i = 0; i < m; i++)
+      qtcol[i] = a[i][j];
+    qr.apply_qt(qtcol);
+    for (size_t i = 0; i < m; i++)
+      EXPECT_NEAR(col[i], qtcol[i], 1e-9);
+  }
+}
+
+TEST(TQR, block_size_does_not_change_factors)
+{
+  const TDynamicVector<TDynamicVector<double>> a = make_tall(30, 20);
+  const TQR<double> q1(a, 1), q8(a, 8);
+
+  for (size_t i = 0; i < 30; i++)
+    for (size_t j = 0; j < 20; j++)
+      EXPECT_NEAR(q1.factors()[i][j], q8.factors()[i][j], 1e-10);
+}
+
+TEST(TQR, least_squares_residual_is_orthogonal_to_columns)
+{
+  const size_t m = 50, n = 12;
+  const TDynamicVector<TDynamicVector<double>> a = make_tall(m, n);
+  TDynamicVector<double> b(m);
+  for (size_t i = 0; i < m; i++)
+    b[i] = double(i % 7) - 3.0;
+  const TDynamicVector<double> x = lstsq(a, b);
+  TDynamicVector<double> r(m);
+  for (size_t i = 0; i < m; i++)
+    r[i] = a[i] * x - b[i];
+  // A^T r = 0
+  for (size_t j = 0; j < n; j++)
+  {
+    double s = 0;
+    for (size_t i = 0; i < m; i++)
+      s += a[i][j] * r[i];
+    EXPECT_NEAR(0.0, s, 1e-9);
+  }
+}
+
+TEST(TQR, square_system_matches_lu)
+{
+  const TDynamicMatrix<double> a = make_matrix(15);
+  TDynamicVector<double> b(15);
+  for (size_t i = 0; i < 15; i++)
+    b[i] = double(i);
+  const TDynamicVector<double> xq = TQR<double>(a).solve(b), xl = solve(a, b);
+
+  for (size_t i = 0; i < 15; i++)
+    EXPECT_NEAR(xl[i], xq[i], 1e-9);
+}
+
+TEST(TQR, throws_for_wide_or_ragged_matrix)
+{
+  ASSERT_ANY_THROW(TQR<double> qr(make_tall(3, 4)));
+  TDynamicVector<TDynamicVector<double>> a = make_tall(4, 3);
+  a[2] = TDynamicVector<double>(2);
+  ASSERT_ANY_THROW(TQR<double> qr(a));
+}
+
+TEST(TQR, throws_when_matrix_is_rank_deficient)
+{
+  TDynamicVector<TDynamicVector<double>> a = make_tall(5, 2);
+  for (size_t i = 0; i < 5; i++)
+    a[i][1] = 0.0;
+
+  ASSERT_ANY_THROW(lstsq(a, TDynamicVector<double>(5)));
+}
+
+TEST(TMatrixPow, zero_power_is_identity)
+{
+  const TDynamicMatrix<int> p = pow(TDynamicMatrix<int>(3), 0);
+
+  for (size_t i = 0; i < 3; i++)
+    for (size_t j = 0; j < 3; j++)
+      EXPECT_EQ(i == j ? 1 : 0, p[i][j]);
+}
+
+TEST(TMatrixPow, computes_fibonacci_numbers)
+{
+  TDynamicMatrix<long long> f(2);
+  f[0][0] = 1; f[0][1] = 1; f[1][0] = 1;
+  const TDynamicMatrix<long long> p = pow(f, 90);
+
+  EXPECT_EQ(2880067194370816120LL, p[0][1]);
+}
+
+TEST(TMatrixPow, matches_repeated_multiplication)
+{
+  TDynamicMatrix<int> a(7);
+  for (size_t i = 0; i < 7; i++)
+    for (size_t j = 0; j < 7; j++)
+      a[i][j] = int((i + 2 * j) % 3) - 1;
+  TDynamicMatrix<int> expected(a);
+  for (int k = 1; k < 13; k++)
+    expected = expected * a;
+
+  EXPECT_EQ(expected, pow(a, 13));
+}
+
+TEST(TMatrixPow, steps_do_not_allocate_below_parallel_threshold)
+{
+  const size_t n = 4;
+  ASSERT_LT(n, gemm_params().par_min_gemm); // выше порога задачи пула выделяют память
+  TDynamicMatrix<double> a(n);
+  for (size_t i = 0; i < n; i++)
+    a[i][(i + 1) % n] = 1.0; // циклическая перестановка
+  const TDynamicMatrix<double> warm = pow(a, 3);
+  size_t before = heap_allocations();
+  const TDynamicMatrix<double> p3 = pow(a, 3);
+  const size_t small = heap_allocations() - before;
+  before = heap_allocations();
+  const TDynamicMatrix<double> p = pow(a, 1000003);
+  const size_t large = heap_allocations() - before;
+
+  EXPECT_EQ(small, large);
+  EXPECT_EQ(p3, p); // 1000003 = 3 (mod 4)
+}
@@ -1,6 +1,8 @@
 #include "tmatrix.h"
 
 #include <gtest.h>
+#include <iomanip>
+#include <sstream>
 
 TEST(TDynamicMatrix, can_create_matrix_with_positive_length)
 {
@@ -26,86 +28,230 @@ TEST(TDynamicMatrix, can_create_copied_matrix)
 
 TEST(TDynamicMatrix, copied_matrix_is_equal_to_source_one)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(3);
+  m[1][2] = 5;
+  TDynamicMatrix<int> m1(m);
+
+  EXPECT_EQ(m, m1);
 }
 
 TEST(TDynamicMatrix, copied_matrix_has_its_own_memory)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(3);
+  TDynamicMatrix<int> m1(m);
+  m1[0][0] = 5;
+
+  EXPECT_EQ(0, m[0][0]);
+  EXPECT_NE(&m[0][0], &m1[0][0]);
 }
 
 TEST(TDynamicMatrix, can_get_size)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(4);
+
+  EXPECT_EQ(4, m.size());
 }
 
 TEST(TDynamicMatrix, can_set_and_get_element)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(4);
+  m[1][3] = 7;
+
+  EXPECT_EQ(7, m[1][3]);
 }
 
 TEST(TDynamicMatrix, throws_when_set_element_with_negative_index)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(4);
+
+  ASSERT_ANY_THROW(m.at(-1).at(0) = 1);
+  ASSERT_ANY_THROW(m.at(0).at(-1) = 1);
 }
 
 TEST(TDynamicMatrix, throws_when_set_element_with_too_large_index)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(4);
+
+  ASSERT_ANY_THROW(m.at(4).at(0) = 1);
+  ASSERT_ANY_THROW(m.at(0).at(4) = 1);
 }
 
 TEST(TDynamicMatrix, can_assign_matrix_to_itself)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(3);
+  m[2][2] = 1;
+  TDynamicMatrix<int>& r = m;
+
+  ASSERT_NO_THROW(m = r);
+  EXPECT_EQ(1, m[2][2]);
 }
 
 TEST(TDynamicMatrix, can_assign_matrices_of_equal_size)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(3), m1(3);
+  m[0][1] = 4;
+  m1 = m;
+
+  EXPECT_EQ(m, m1);
 }
 
 TEST(TDynamicMatrix, assign_operator_change_matrix_size)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(3), m1(5);
+  m1 = m;
+
+  EXPECT_EQ(3, m1.size());
 }
 
 TEST(TDynamicMatrix, can_assign_matrices_of_different_size)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(3), m1(5);
+  m[1][1] = 8;
+  m1 = m;
+
+  EXPECT_EQ(m, m1);
 }
 
 TEST(TDynamicMatrix, compare_equal_matrices_return_true)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(3), m1(3);
+  m[2][0] = m1[2][0] = 6;
+
+  EXPECT_TRUE(m == m1);
 }
 
 TEST(TDynamicMatrix, compare_matrix_with_itself_return_true)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(3);
+
+  EXPECT_TRUE(m == m);
 }
 
 TEST(TDynamicMatrix, matrices_with_different_size_are_not_equal)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(3), m1(4);
+
+  EXPECT_TRUE(m != m1);
 }
 
 TEST(TDynamicMatrix, can_add_matrices_with_equal_size)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(2), m1(2);
+  m[0][0] = 1; m[1][1] = 2;
+  m1[0][0] = 10; m1[0][1] = 20;
+  TDynamicMatrix<int> r = m + m1;
+
+  EXPECT_EQ(11, r[0][0]);
+  EXPECT_EQ(20, r[0][1]);
+  EXPECT_EQ(0, r[1][0]);
+  EXPECT_EQ(2, r[1][1]);
 }
 
 TEST(TDynamicMatrix, cant_add_matrices_with_not_equal_size)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(2), m1(3);
+
+  ASSERT_ANY_THROW(m + m1);
 }
 
 TEST(TDynamicMatrix, can_subtract_matrices_with_equal_size)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(2), m1(2);
+  m[0][0] = 1; m[1][1] = 2;
+  m1[0][0] = 10; m1[0][1] = 20;
+  TDynamicMatrix<int> r = m1 - m;
+
+  EXPECT_EQ(9, r[0][0]);
+  EXPECT_EQ(20, r[0][1]);
+  EXPECT_EQ(0, r[1][0]);
+  EXPECT_EQ(-2, r[1][1]);
 }
 
 TEST(TDynamicMatrix, cant_subtract_matrixes_with_not_equal_size)
 {
-  ADD_FAILURE();
+  TDynamicMatrix<int> m(2), m1(3);
+
+  ASSERT_ANY_THROW(m - m1);
+}
+
+TEST(TDynamicMatrix, can_multiply_matrix_by_scalar)
+{
+  TDynamicMatrix<int> m(2);
+  m[0][1] = 3;
+  TDynamicMatrix<int> r = m * 2;
+
+  EXPECT_EQ(6, r[0][1]);
+  EXPECT_EQ(0, r[1][0]);
+}
+
+TEST(TDynamicMatrix, can_multiply_matrix_by_vector)
+{
+  TDynamicMatrix<int> m(2);
+  m[0][0] = 1; m[0][1] = 2;
+  m[1][0] = 3; m[1][1] = 4;
+  TDynamicVector<int> v(2);
+  v[0] = 5; v[1] = 6;
+  TDynamicVector<int> r = m * v;
+
+  EXPECT_EQ(17, r[0]);
+  EXPECT_EQ(39, r[1]);
+}
+
+TEST(TDynamicMatrix, can_multiply_matrices_with_equal_size)
+{
+  TDynamicMatrix<int> m(2), m1(2);
+  m[0][0] = 1; m[0][1] = 2;
+  m[1][0] = 3; m[1][1] = 4;
+  m1[0][0] = 5; m1[0][1] = 6;
+  m1[1][0] = 7; m1[1][1] = 8;
+  TDynamicMatrix<int> r = m * m1;
+
+  EXPECT_EQ(19, r[0][0]);
+  EXPECT_EQ(22, r[0][1]);
+  EXPECT_EQ(43, r[1][0]);
+  EXPECT_EQ(50, r[1][1]);
+}
+
+TEST(TDynamicMatrix, cant_multiply_matrices_with_not_equal_size)
+{
+  TDynamicMatrix<int> m(2), m1(3);
+
+  ASSERT_ANY_THROW(m * m1);
+}
+
+TEST(TDynamicMatrix, can_read_matrix)
+{
+  TDynamicMatrix<double> m(2);
+  istringstream in("1 2.5\n-3 4e1\n");
+  in >> m;
+
+  EXPECT_FALSE(in.fail());
+  EXPECT_EQ(2.5, m[0][1]);
+  EXPECT_EQ(-3.0, m[1][0]);
+  EXPECT_EQ(40.0, m[1][1]);
 }
 
+TEST(TDynamicMatrix, can_write_matrix)
+{
+  TDynamicMatrix<int> m(2);
+  m[0][0] = 1; m[0][1] = 2;
+  m[1][0] = 3; m[1][1] = 4;
+  ostringstream out;
+  out << m;
+
+  EXPECT_EQ("1 2 \n3 4 \n", out.str());
+}
+
+TEST(TDynamicMatrix, write_respects_stream_precision)
+{
+  TDynamicMatrix<double> m(2);
+  m[0][0] = 1.0 / 3; m[0][1] = 2.5;
+  m[1][0] = -2.0 / 3; m[1][1] = 1e-7;
+  ostringstream out, expected;
+  out << setprecision(4) << m;
+  expected << setprecision(4);
+  for (size_t i = 0; i < 2; i++)
+    expected << m[i][0] << ' ' << m[i][1] << " \n";
+
+  EXPECT_EQ(expected.str(), out.str());
+}
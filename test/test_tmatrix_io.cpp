@@ -0,0 +1,269 @@
+#include "tmatrix_io.h"
+
+#include <gtest.h>
+#include <cstdio>
+#include <sstream>
+
+namespace
+{
+  // файл .npy версии 1.0 с заданным словарём заголовка и data_size байтами данных
+  string make_npy(const string& dict, size_t data_size)
+  {
+    const string d = dict + '\n';
+    string res = string("\x93NUMPY\x01\x00", 8) + char(d.size() & 0xff) + char(d.size() >> 8) + d;
+    return res + string(data_size, '\0');
+  }
+}
+
+TEST(TMatrixIO, can_load_matrix_from_text)
+{
+  const string text = "1 2 3\n\n4 5 6\r\n7 8 9";
+  TDynamicMatrix<int> m(3);
+  load_text(text.data(), text.size(), m);
+
+  EXPECT_EQ(2, m[0][1]);
+  EXPECT_EQ(6, m[1][2]);
+  EXPECT_EQ(9, m[2][2]);
+}
+
+TEST(TMatrixIO, throws_when_row_count_mismatch)
+{
+  const string text = "1 2\n3 4\n5 6\n";
+  TDynamicMatrix<int> m(2);
+
+  ASSERT_ANY_THROW(load_text(text.data(), text.size(), m));
+}
+
+TEST(TMatrixIO, throws_when_row_is_malformed)
+{
+  const string text = "1 2\n3 4 5\n";
+  TDynamicMatrix<int> m(2);
+
+  ASSERT_ANY_THROW(load_text(text.data(), text.size(), m));
+}
+
+TEST(TMatrixIO, loaded_large_matrix_is_equal_to_written_one)
+{
+  const size_t n = 700;
+  TDynamicMatrix<double> m(n), m1(n);
+  for (size_t i = 0; i < n; i++)
+    for (size_t j = 0; j < n; j++)
+      m[i][j] = double(i) / (j + 1);
+  ostringstream out;
+  out << m;
+  const string text = out.str();
+  load_text(text.data(), text.size(), m1);
+
+  EXPECT_EQ(m, m1);
+}
+
+TEST(TMatrixIO, can_load_matrix_from_file)
+{
+  const string path = "test_tmatrix_io_load.txt";
+  {
+    ofstream f(path);
+    f << "1.5 2\n3 -4\n";
+  }
+  TDynamicMatrix<double> m(2);
+  load_text_file(path, m);
+  remove(path.c_str());
+
+  EXPECT_EQ(1.5, m[0][0]);
+  EXPECT_EQ(-4.0, m[1][1]);
+}
+
+TEST(TMatrixIO, can_read_coordinate_mtx_into_dense_matrix)
+{
+  istringstream in(
+    "%%MatrixMarket matrix coordinate real symmetric\n"
+    "% comment\n"
+    "3 3 3\n"
+    "1 1 2.5\n"
+    "3 1 -1\n"
+    "2 2 4\n");
+  TDynamicMatrix<double> m;
+  mtx_read(in, m);
+
+  EXPECT_EQ(3, m.size());
+  EXPECT_EQ(2.5, m[0][0]);
+  EXPECT_EQ(-1.0, m[2][0]);
+  EXPECT_EQ(-1.0, m[0][2]);
+  EXPECT_EQ(0.0, m[1][0]);
+}
+
+TEST(TMatrixIO, duplicate_mtx_entries_are_summed_by_both_readers)
+{
+  const string text =
+    "%%MatrixMarket matrix coordinate real symmetric\n"
+    "2 2 4\n"
+    "1 1 1.5\n"
+    "2 1 -1\n"
+    "1 1 2\n"
+    "2 1 4\n";
+  TDynamicMatrix<double> d;
+  TSparseMatrix<double> s;
+  istringstream in_d(text), in_s(text);
+  mtx_read(in_d, d);
+  mtx_read(in_s, s);
+
+  EXPECT_EQ(3.5, d[0][0]);
+  EXPECT_EQ(3.0, d[1][0]);
+  EXPECT_EQ(3.0, d[0][1]);
+  for (size_t i = 0; i < 2; i++)
+    for (size_t j = 0; j < 2; j++)
+      EXPECT_EQ(d[i][j], s(i, j));
+}
+
+TEST(TMatrixIO, can_read_array_mtx_into_sparse_matrix)
+{
+  istringstream in(
+    "%%MatrixMarket matrix array integer general\n"
+    "2 3\n"
+    "1\n0\n0\n2\n3\n0\n");
+  TSparseMatrix<int> m;
+  mtx_read(in, m);
+
+  EXPECT_EQ(2, m.rows());
+  EXPECT_EQ(3, m.cols());
+  EXPECT_EQ(3, m.nnz());
+  EXPECT_EQ(1, m(0, 0));
+  EXPECT_EQ(2, m(1, 1));
+  EXPECT_EQ(3, m(0, 2));
+}
+
+TEST(TMatrixIO, throws_when_mtx_header_is_invalid)
+{
+  istringstream in("%%MatrixMarket matrix coordinate complex general\n1 1 1\n1 1 1 0\n");
+  TDynamicMatrix<double> m;
+
+  ASSERT_ANY_THROW(mtx_read(in, m));
+}
+
+TEST(TMatrixIO, dense_mtx_write_read_round_trip)
+{
+  TDynamicMatrix<double> m(3), m1;
+  for (size_t i = 0; i < 3; i++)
+    for (size_t j = 0; j < 3; j++)
+      m[i][j] = 0.1 * i - j;
+  stringstream io;
+  mtx_write(io, m);
+  mtx_read(io, m1);
+
+  EXPECT_EQ(m, m1);
+}
+
+TEST(TMatrixIO, sparse_mtx_write_read_round_trip)
+{
+  TSparseMatrix<int> m(3, 4, { 0, 2, 2, 0 }, { 3, 1, 0, 3 }, { 5, 6, 7, 1 }), m1;
+  stringstream io;
+  mtx_write(io, m);
+  mtx_read(io, m1);
+
+  EXPECT_EQ(6, m1(0, 3));
+  EXPECT_EQ(m, m1);
+}
+
+TEST(TMatrixIO, npy_vector_write_read_round_trip)
+{
+  TDynamicVector<double> v(5), v1;
+  for (size_t i = 0; i < 5; i++)
+    v[i] = 0.5 * i;
+  stringstream io;
+  npy_write(io, v);
+  npy_read(io, v1);
+
+  EXPECT_EQ(v, v1);
+}
+
+TEST(TMatrixIO, npy_header_is_aligned_to_64_bytes)
+{
+  TDynamicMatrix<float> m(3);
+  ostringstream out;
+  npy_write(out, m);
+
+  EXPECT_EQ(0, (out.str().size() - 3 * 3 * sizeof(float)) % 64);
+  EXPECT_EQ(0, out.str().compare(1, 5, "NUMPY"));
+}
+
+TEST(TMatrixIO, npy_read_converts_element_type)
+{
+  TDynamicMatrix<int32_t> m(2);
+  m[0][1] = 7; m[1][0] = -3;
+  stringstream io;
+  npy_write(io, m);
+  TDynamicMatrix<double> m1;
+  npy_read(io, m1);
+
+  EXPECT_EQ(7.0, m1[0][1]);
+  EXPECT_EQ(-3.0, m1[1][0]);
+}
+
+TEST(TMatrixIO, npy_read_handles_fortran_order)
+{
+  const string dict = "{'descr': '<i8', 'fortran_order': True, 'shape': (2, 2), }";
+  string text = string("\x93NUMPY\x01\x00", 8) + char(dict.size()) + '\0' + dict;
+  const int64_t data[4] = { 1, 2, 3, 4 }; // столбцы (1, 2) и (3, 4)
+  text.append(reinterpret_cast<const char*>(data), sizeof(data));
+  istringstream in(text);
+  TDynamicMatrix<int64_t> m;
+  npy_read(in, m);
+
+  EXPECT_EQ(1, m[0][0]);
+  EXPECT_EQ(3, m[0][1]);
+  EXPECT_EQ(2, m[1][0]);
+}
+
+TEST(TMatrixIO, throws_when_npy_shape_is_not_square)
+{
+  TDynamicVector<double> v(4);
+  stringstream io;
+  npy_write(io, v);
+  TDynamicMatrix<double> m;
+
+  ASSERT_ANY_THROW(npy_read(io, m));
+}
+
+TEST(TMatrixIO, npy_file_can_be_viewed_without_copy)
+{
+  const string path = "test_tmatrix_io_view.npy";
+  TDynamicMatrix<double> m(3), m1;
+  m[2][1] = 1.25;
+  {
+    ofstream f(path, ios::binary);
+    npy_write(f, m);
+  }
+  {
+    TNpyView<double> view(path);
+    EXPECT_EQ(2, view.shape().size());
+    EXPECT_EQ(1.25, view[2][1]);
+    ASSERT_ANY_THROW(TNpyView<float> bad(path));
+    npy_read_file(path, m1);
+  }
+  remove(path.c_str());
+
+  EXPECT_EQ(m, m1);
+}
+
+TEST(TMatrixIO, throws_on_malformed_npy_header)
+{
+  // 2^32 * 2^32 * 8 байт по модулю 2^64 равно нулю
+  const string overflow = "{'descr': '<f8', 'fortran_order': False, 'shape': (4294967296, 4294967296), }";
+  const string rank3 = "{'descr': '<f8', 'fortran_order': False, 'shape': (2, 2, 2), }";
+  const string unclosed = "{'descr': '<f8', 'fortran_order': False, 'shape': (2, 2";
+  const string path = "test_tmatrix_io_bad.npy";
+  for (const string& dict : { overflow, rank3, unclosed })
+  {
+    SCOPED_TRACE(dict);
+    const string file = make_npy(dict, 64);
+    {
+      ofstream f(path, ios::binary);
+      f.write(file.data(), file.size());
+    }
+    TDynamicMatrix<double> m;
+    istringstream in(file);
+    EXPECT_ANY_THROW(npy_read(in, m));
+    EXPECT_ANY_THROW(npy_read_file(path, m));
+    EXPECT_ANY_THROW(TNpyView<double> view(path));
+  }
+  remove(path.c_str());
+}
@@ -0,0 +1,208 @@
+#include "toperator.h"
+#include "tsolvers.h"
+
+#include <gtest.h>
+
+namespace
+{
+  TDynamicMatrix<double> make_matrix(size_t n)
+  {
+    TDynamicMatrix<double> a(n);
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < n; j++)
+        a[i][j] = double((i * 7 + j * 3) % 11) - 5.0 + (i == j ? 20.0 : 0.0);
+    return a;
+  }
+
+  TDynamicVector<double> make_vector(size_t n, size_t seed)
+  {
+    TDynamicVector<double> v(n);
+    for (size_t i = 0; i < n; i++)
+      v[i] = double((i + seed) % 7) - 3.0;
+    return v;
+  }
+
+  TDynamicMatrix<double> transposed(const TDynamicMatrix<double>& a)
+  {
+    TDynamicMatrix<double> t(a.size());
+    for (size_t i = 0; i < a.size(); i++)
+      for (size_t j = 0; j < a.size(); j++)
+        t[j][i] = a[i][j];
+    return t;
+  }
+
+  // make_operator(M) допустим для аргумента типа M
+  template<typename M, typename = void>
+  struct can_make_operator : false_type {};
+  template<typename M>
+  struct can_make_operator<M, void_t<decltype(make_operator(declval<M>()))>> : true_type {};
+
+  double max_diff(const TDynamicVector<double>& x, const TDynamicVector<double>& y)
+  {
+    double d = 0.0;
+    for (size_t i = 0; i < x.size(); i++)
+      d = max(d, fabs(x[i] - y[i]));
+    return d;
+  }
+}
+
+TEST(TLinearOperator, dense_operator_matches_matrix_product)
+{
+  const size_t n = 37;
+  const TDynamicMatrix<double> a = make_matrix(n);
+  const TDynamicVector<double> x = make_vector(n, 1);
+  const TLinearOperator<double> op = make_operator(a);
+
+  EXPECT_EQ(n, op.rows());
+  EXPECT_EQ(n, op.cols());
+  EXPECT_LT(max_diff(a * x, op * x), 1e-12);
+}
+
+TEST(TLinearOperator, dense_transpose_matches_transposed_matrix)
+{
+  const size_t n = 29;
+  const TDynamicMatrix<double> a = make_matrix(n);
+  const TDynamicVector<double> x = make_vector(n, 2);
+  const TLinearOperator<double> op = make_operator(a);
+  TDynamicVector<double> y(n);
+
+  ASSERT_TRUE(op.has_transpose());
+  op.apply_transpose(x, y);
+  EXPECT_LT(max_diff(transposed(a) * x, y), 1e-12);
+  EXPECT_LT(max_diff(transposed(a) * x, op.transpose() * x), 1e-12);
+}
+
+TEST(TLinearOperator, dense_block_apply_matches_single_vectors)
+{
+  const size_t n = 70, nrhs = 5;
+  const TDynamicMatrix<double> a = make_matrix(n);
+  const TLinearOperator<double> op = make_operator(a);
+  TDynamicVector<TDynamicVector<double>> x(nrhs), y(nrhs);
+  for (size_t j = 0; j < nrhs; j++)
+  {
+    x[j] = make_vector(n, j);
+    y[j] = TDynamicVector<double>(n);
+  }
+
+  op.apply(x, y);
+  for (size_t j = 0; j < nrhs; j++)
+    EXPECT_LT(max_diff(a * x[j], y[j]), 1e-12);
+}
+
+TEST(TLinearOperator, sparse_operator_and_transpose_match_dense)
+{
+  const size_t m = 6, n = 4;
+  const vector<size_t> ri = { 0, 0, 1, 3, 4, 5, 5 };
+  const vector<size_t> ci = { 0, 3, 1, 2, 0, 1, 3 };
+  const vector<double> v = { 1.0, 2.0, -3.0, 4.0, 5.0, -6.0, 7.0 };
+  const TSparseMatrix<double> s(m, n, ri, ci, v);
+  const TLinearOperator<double> op = make_operator(s);
+  const TDynamicVector<double> x = make_vector(n, 3), u = make_vector(m, 4);
+  TDynamicVector<double> y(m), w(n);
+
+  EXPECT_EQ(m, op.rows());
+  EXPECT_EQ(n, op.cols());
+  op.apply(x, y);
+  op.apply_transpose(u, w);
+  for (size_t i = 0; i < m; i++)
+  {
+    double yi = 0.0;
+    for (size_t j = 0; j < n; j++)
+      yi += s(i, j) * x[j];
+    EXPECT_DOUBLE_EQ(yi, y[i]);
+  }
+  for (size_t j = 0; j < n; j++)
+  {
+    double wj = 0.0;
+    for (size_t i = 0; i < m; i++)
+      wj += s(i, j) * u[i];
+    EXPECT_DOUBLE_EQ(wj, w[j]);
+  }
+}
+
+TEST(TLinearOperator, diagonal_operator_scales_components)
+{
+  const TDynamicVector<double> d = make_vector(9, 5);
+  const TDynamicVector<double> x = make_vector(9, 6);
+  const TLinearOperator<double> op = diagonal_operator(d);
+  const TDynamicVector<double> y = op * x;
+
+  for (size_t i = 0; i < d.size(); i++)
+    EXPECT_EQ(d[i] * x[i], y[i]);
+}
+
+TEST(TLinearOperator, function_operator_without_transpose_throws)
+{
+  const TLinearOperator<double> op(3, 3, [](const TDynamicVector<double>& x, TDynamicVector<double>& y) {
+    for (size_t i = 0; i < x.size(); i++)
+      y[i] = 2.0 * x[i];
+  });
+  TDynamicVector<double> x(3), y(3);
+
+  EXPECT_FALSE(op.has_transpose());
+  ASSERT_ANY_THROW(op.apply_transpose(x, y));
+  ASSERT_ANY_THROW(op.transpose());
+}
+
+TEST(TLinearOperator, throws_when_sizes_do_not_match)
+{
+  const TDynamicMatrix<double> a = make_matrix(4);
+  const TLinearOperator<double> op = make_operator(a);
+  TDynamicVector<double> x(4), y(5);
+
+  ASSERT_ANY_THROW(op.apply(x, y));
+  ASSERT_ANY_THROW(op.apply(y, x));
+}
+
+TEST(TLinearOperator, cant_create_from_temporary_matrix)
+{
+  EXPECT_TRUE((can_make_operator<const TDynamicMatrix<double>&>::value));
+  EXPECT_FALSE((can_make_operator<TDynamicMatrix<double>>::value));
+  EXPECT_TRUE((can_make_operator<const TSparseMatrix<double>&>::value));
+  EXPECT_FALSE((can_make_operator<TSparseMatrix<double>>::value));
+}
+
+TEST(TLinearOperator, dense_operator_sees_row_swaps)
+{
+  const size_t n = 12;
+  TDynamicMatrix<double> a = make_matrix(n);
+  const TLinearOperator<double> op = make_operator(a);
+  const TDynamicVector<double> x = make_vector(n, 3);
+
+  a.swap_rows(0, 7);
+  EXPECT_LT(max_diff(a * x, op * x), 1e-12);
+}
+
+TEST(TLinearOperator, throws_when_matrix_size_changed)
+{
+  TDynamicMatrix<double> a = make_matrix(4);
+  const TLinearOperator<double> op = make_operator(a);
+  TDynamicVector<double> x(4), y(4);
+
+  a = make_matrix(5);
+  ASSERT_ANY_THROW(op.apply(x, y));
+  ASSERT_ANY_THROW(op.apply_transpose(x, y));
+}
+
+TEST(TLinearOperator, cant_create_without_apply_function)
+{
+  ASSERT_ANY_THROW(TLinearOperator<double>(2, 2, nullptr));
+  ASSERT_ANY_THROW(TLinearOperator<double>(0, 2, [](const TDynamicVector<double>&, TDynamicVector<double>&) {}));
+}
+
+TEST(TLinearOperator, conjugate_gradient_accepts_operator)
+{
+  const size_t n = 30;
+  const TDynamicMatrix<double> a = make_matrix(n);
+  const TDynamicMatrix<double> spd = transposed(a) * a;
+  const TLinearOperator<double> op = make_operator(spd);
+  const TDynamicVector<double> b = make_vector(n, 7);
+  TDynamicVector<double> x(n);
+  TCGSolver<double> cg(n);
+  TIterControl ctl;
+  ctl.tol = 1e-10;
+  const TIterResult res = cg.solve(op, b, x, TJacobiPreconditioner<double>(spd), ctl);
+
+  EXPECT_TRUE(res.converged);
+  EXPECT_LT(max_diff(spd * x, b), 1e-6);
+}
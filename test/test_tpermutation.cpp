@@ -0,0 +1,98 @@
+#include "tpermutation.h"
+
+#include <gtest.h>
+
+TEST(TPermutation, created_permutation_is_identity)
+{
+  TPermutation p(4);
+
+  for (size_t i = 0; i < 4; i++)
+    EXPECT_EQ(i, p[i]);
+  EXPECT_EQ(1, p.sign());
+}
+
+TEST(TPermutation, swap_changes_sign)
+{
+  TPermutation p(3);
+  p.swap(0, 2);
+  EXPECT_EQ(-1, p.sign());
+  p.swap(1, 1);
+  EXPECT_EQ(-1, p.sign());
+  p.swap(0, 1);
+  EXPECT_EQ(1, p.sign());
+}
+
+TEST(TPermutation, throws_when_swap_index_is_out_of_range)
+{
+  TPermutation p(3);
+
+  ASSERT_ANY_THROW(p.swap(0, 3));
+}
+
+TEST(TPermutation, swap_rows_does_not_copy_row_data)
+{
+  TDynamicMatrix<int> m(3);
+  m[0][0] = 1; m[2][0] = 3;
+  const int* row0 = &m[0][0];
+  const int* row2 = &m[2][0];
+  m.swap_rows(0, 2);
+
+  EXPECT_EQ(row2, &m[0][0]);
+  EXPECT_EQ(row0, &m[2][0]);
+  EXPECT_EQ(3, m[0][0]);
+}
+
+TEST(TPermutation, throws_when_swap_rows_index_is_out_of_range)
+{
+  TDynamicMatrix<int> m(3);
+
+  ASSERT_ANY_THROW(m.swap_rows(1, 3));
+}
+
+TEST(TPermutation, apply_moves_rows_to_their_positions)
+{
+  // цикл 0 -> 1 -> 3 -> 0 и неподвижная точка 2
+  TPermutation p(4);
+  p.swap(0, 1);
+  p.swap(1, 3);
+  TDynamicMatrix<int> m(4);
+  TDynamicVector<int> v(4);
+  for (size_t i = 0; i < 4; i++)
+  {
+    m[i][0] = int(i);
+    v[i] = int(i);
+  }
+  p.apply(m);
+  p.apply(v);
+
+  for (size_t i = 0; i < 4; i++)
+  {
+    EXPECT_EQ(int(p[i]), m[i][0]);
+    EXPECT_EQ(int(p[i]), v[i]);
+  }
+}
+
+TEST(TPermutation, inverse_undoes_apply)
+{
+  TPermutation p(5);
+  p.swap(0, 4);
+  p.swap(1, 4);
+  p.swap(2, 3);
+  TDynamicVector<int> v(5);
+  for (size_t i = 0; i < 5; i++)
+    v[i] = int(10 * i);
+  TDynamicVector<int> w(v);
+  p.apply(w);
+  p.inverse().apply(w);
+
+  EXPECT_EQ(v, w);
+  EXPECT_EQ(p.sign(), p.inverse().sign());
+}
+
+TEST(TPermutation, throws_when_apply_size_differs)
+{
+  TPermutation p(3);
+  TDynamicMatrix<int> m(4);
+
+  ASSERT_ANY_THROW(p.apply(m));
+}
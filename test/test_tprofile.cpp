@@ -0,0 +1,180 @@
+#include "tmatrix.h"
+
+#include <gtest.h>
+#include <sstream>
+#include <thread>
+
+TEST(TAllocCounter, counts_vector_copies_and_allocations)
+{
+  TDynamicVector<double> v(10);
+  TAllocCounter<TDynamicVector<double>>::reset();
+  TDynamicVector<double> v1(v);
+  TDynamicVector<double> v2(std::move(v1));
+  const TAllocStats s = TAllocCounter<TDynamicVector<double>>::snapshot();
+
+  EXPECT_EQ(0, s.constructions);
+  EXPECT_EQ(1, s.copy_constructions);
+  EXPECT_EQ(1, s.move_constructions);
+  EXPECT_EQ(1, s.allocations);
+  EXPECT_EQ(10 * sizeof(double), s.bytes_allocated);
+}
+
+TEST(TAllocCounter, assignment_of_equal_size_does_not_allocate)
+{
+  TDynamicVector<int> v(5), v1(5), v2(3);
+  const TAllocStats before = TAllocCounter<TDynamicVector<int>>::snapshot();
+  v1 = v;
+  const TAllocStats same = TAllocCounter<TDynamicVector<int>>::snapshot() - before;
+  v2 = v;
+  const TAllocStats other = TAllocCounter<TDynamicVector<int>>::snapshot() - before;
+
+  EXPECT_EQ(1, same.copy_assignments);
+  EXPECT_EQ(0, same.allocations);
+  EXPECT_EQ(2, other.copy_assignments);
+  EXPECT_EQ(1, other.allocations);
+}
+
+TEST(TAllocCounter, vector_sum_allocates_once)
+{
+  TDynamicVector<double> a(100), b(100);
+  const TAllocStats before = TAllocCounter<void>::snapshot();
+  TDynamicVector<double> c = a + b;
+  const TAllocStats s = TAllocCounter<void>::snapshot() - before;
+
+  EXPECT_EQ(1, s.allocations);
+  EXPECT_EQ(100 * sizeof(double), s.bytes_allocated);
+}
+
+TEST(TAllocCounter, counts_matrix_copies)
+{
+  TDynamicMatrix<int> m(4), m1(4);
+  TAllocCounter<TDynamicMatrix<int>>::reset();
+  TDynamicMatrix<int> m2(m);
+  const TAllocStats before = TAllocCounter<void>::snapshot();
+  m1 = m;
+  const TAllocStats assign = TAllocCounter<void>::snapshot() - before;
+  const TAllocStats s = TAllocCounter<TDynamicMatrix<int>>::snapshot();
+
+  EXPECT_EQ(1, s.copy_constructions);
+  EXPECT_EQ(1, s.copy_assignments);
+  EXPECT_EQ(0, assign.allocations);
+}
+
+TEST(TOpAccounting, records_matmul_flops_and_bytes)
+{
+  TDynamicMatrix<double> a(8), b(8);
+  TOpAccounting::reset();
+  TDynamicMatrix<double> c = a * b;
+  const TOpStats s = TOpAccounting::stats(OP_MATMUL);
+
+  EXPECT_EQ(1, s.calls);
+  EXPECT_EQ(2 * 8 * 8 * 8, s.flops);
+  EXPECT_EQ(2 * 8 * 8 * sizeof(double), s.bytes_read);
+  EXPECT_EQ(8 * 8 * sizeof(double), s.bytes_written);
+  EXPECT_EQ(0, TOpAccounting::stats(OP_DOT).calls);
+}
+
+TEST(TOpAccounting, nested_operations_are_not_counted_twice)
+{
+  TDynamicMatrix<int> m(3);
+  TDynamicVector<int> v(3);
+  istringstream in("1 2 3\n4 5 6\n7 8 9\n");
+  TOpAccounting::reset();
+  in >> m;
+  TDynamicVector<int> r = m * v;
+
+  EXPECT_EQ(1, TOpAccounting::stats(OP_IO).calls);
+  EXPECT_EQ(1, TOpAccounting::stats(OP_MATVEC).calls);
+  EXPECT_EQ(0, TOpAccounting::stats(OP_DOT).calls);
+}
+
+TEST(TOpAccounting, can_dump_json)
+{
+  TDynamicVector<double> v(4);
+  TOpAccounting::reset();
+  TDynamicVector<double> r = v + v;
+  ostringstream out;
+  TOpAccounting::dump_json(out);
+
+  EXPECT_NE(string::npos, out.str().find("\"add\": {\"calls\": 1, \"flops\": 4"));
+  EXPECT_NE(string::npos, out.str().find("\"matmul\": {\"calls\": 0"));
+}
+
+TEST(TPerfReport, records_matmul_time_with_or_without_counters)
+{
+  TDynamicMatrix<double> a(32), b(32);
+  TPerfReport::reset();
+  TDynamicMatrix<double> c = a * b;
+  const TPerfStats s = TPerfReport::stats(OP_MATMUL);
+
+  EXPECT_EQ(1, s.calls);
+  EXPECT_GT(s.seconds, 0.0);
+  if (s.counters)
+    EXPECT_GT(s.cycles + s.instructions, 0);
+  else
+    EXPECT_EQ(0, s.cycles);
+}
+
+TEST(TPerfReport, can_dump_json)
+{
+  TPerfReport::reset();
+  ostringstream out;
+  TPerfReport::dump_json(out);
+
+  EXPECT_NE(string::npos, out.str().find("\"matvec\": {\"calls\": 0"));
+  EXPECT_NE(string::npos, out.str().find("\"llc_misses\""));
+}
+
+TEST(TTracer, records_begin_and_end_events)
+{
+  TTracer& tracer = TTracer::instance();
+  tracer.clear();
+  TDynamicMatrix<double> a(4), b(4);
+  TDynamicMatrix<double> c = a * b;
+  ostringstream out;
+  tracer.write_json(out);
+  const string json = out.str();
+
+  EXPECT_EQ(0, json.find("{\"traceEvents\": ["));
+  EXPECT_NE(string::npos, json.find("\"name\": \"matmul\", \"cat\": \"tmatrix\", \"ph\": \"B\""));
+  EXPECT_NE(string::npos, json.find("\"name\": \"matmul\", \"cat\": \"tmatrix\", \"ph\": \"E\""));
+  EXPECT_NE(string::npos, json.find("\"args\": {\"n\": 4}"));
+}
+
+TEST(TTracer, disabled_tracer_records_nothing)
+{
+  TTracer& tracer = TTracer::instance();
+  tracer.clear();
+  tracer.enable(false);
+  TDynamicVector<double> v(4);
+  double d = v * v;
+  tracer.enable();
+  ostringstream out;
+  tracer.write_json(out);
+
+  EXPECT_EQ(0.0, d);
+  EXPECT_EQ(string::npos, out.str().find("\"dot\""));
+}
+
+TEST(TTracer, events_of_each_thread_have_own_tid)
+{
+  TTracer& tracer = TTracer::instance();
+  tracer.clear();
+  TDynamicVector<double> v(4);
+  double d = v * v;
+  thread t([] { TDynamicVector<double> w(4); double e = w * w; (void)e; });
+  t.join();
+  ostringstream out;
+  tracer.write_json(out);
+  const string json = out.str();
+  vector<string> tids;
+  for (size_t p = json.find("\"ph\": \"B\""); p != string::npos; p = json.find("\"ph\": \"B\"", p + 1))
+  {
+    const size_t t = json.find("\"tid\": ", p) + 7;
+    tids.push_back(json.substr(t, json.find(',', t) - t));
+  }
+
+  EXPECT_EQ(0.0, d);
+  ASSERT_EQ(2, tids.size());
+  EXPECT_NE(tids[0], tids[1]);
+}
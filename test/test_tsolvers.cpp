@@ -0,0 +1,225 @@
+#include "tsolvers.h"
+
+#include <gtest.h>
+
+#include "test_heap.h"
+
+namespace
+{
+  // одномерный оператор Лапласа с усиленной диагональю: 2+s на диагонали, -1 рядом
+  TSparseMatrix<double> make_laplace(size_t n, double shift)
+  {
+    vector<size_t> ri, ci;
+    vector<double> v;
+    for (size_t i = 0; i < n; i++)
+    {
+      ri.push_back(i); ci.push_back(i); v.push_back(2.0 + shift + double(i % 3));
+      if (i > 0)
+      {
+        ri.push_back(i); ci.push_back(i - 1); v.push_back(-1.0);
+      }
+      if (i + 1 < n)
+      {
+        ri.push_back(i); ci.push_back(i + 1); v.push_back(-1.0);
+      }
+    }
+    return TSparseMatrix<double>(n, n, ri, ci, v);
+  }
+
+  TDynamicMatrix<double> to_dense(const TSparseMatrix<double>& a)
+  {
+    TDynamicMatrix<double> m(a.rows());
+    for (size_t i = 0; i < a.rows(); i++)
+      for (size_t j = 0; j < a.cols(); j++)
+        m[i][j] = a(i, j);
+    return m;
+  }
+
+  TDynamicVector<double> make_rhs(size_t n)
+  {
+    TDynamicVector<double> b(n);
+    for (size_t i = 0; i < n; i++)
+      b[i] = double(i % 5) - 2.0;
+    return b;
+  }
+
+  double residual(const TDynamicMatrix<double>& a, const TDynamicVector<double>& x, const TDynamicVector<double>& b)
+  {
+    const TDynamicVector<double> r = a * x - b;
+    return sqrt((r * r) / (b * b));
+  }
+}
+
+TEST(TCGSolver, solves_dense_spd_system)
+{
+  const size_t n = 40;
+  const TDynamicMatrix<double> a = to_dense(make_laplace(n, 0.5));
+  const TDynamicVector<double> b = make_rhs(n);
+  TDynamicVector<double> x(n);
+  TCGSolver<double> cg(n);
+  const TIterResult res = cg.solve(a, b, x);
+
+  EXPECT_TRUE(res.converged);
+  EXPECT_LE(res.iterations, n);
+  EXPECT_LT(residual(a, x, b), 1e-7);
+}
+
+TEST(TCGSolver, jacobi_preconditioner_works_with_sparse_matrix)
+{
+  const size_t n = 200;
+  const TSparseMatrix<double> a = make_laplace(n, 0.01);
+  const TDynamicVector<double> b = make_rhs(n);
+  TDynamicVector<double> x(n), x0(n);
+  TCGSolver<double> cg(n);
+  const TIterResult plain = cg.solve(a, b, x0);
+  const TIterResult jacobi = cg.solve(a, b, x, TJacobiPreconditioner<double>(a));
+
+  EXPECT_TRUE(plain.converged);
+  EXPECT_TRUE(jacobi.converged);
+  EXPECT_LT(residual(to_dense(a), x, b), 1e-7);
+}
+
+TEST(TCGSolver, accepts_matrix_free_operator)
+{
+  const size_t n = 100;
+  // y = (3 I - сдвиг влево - сдвиг вправо) x, без хранения матрицы
+  auto op = [n](const TDynamicVector<double>& x, TDynamicVector<double>& y) {
+    for (size_t i = 0; i < n; i++)
+      y[i] = 3.0 * x[i] - (i > 0 ? x[i - 1] : 0.0) - (i + 1 < n ? x[i + 1] : 0.0);
+  };
+  const TDynamicVector<double> b = make_rhs(n);
+  TDynamicVector<double> x(n), y(n);
+  TCGSolver<double> cg(n);
+
+  EXPECT_TRUE(cg.solve(op, b, x).converged);
+  op(x, y);
+  for (size_t i = 0; i < n; i++)
+    EXPECT_NEAR(b[i], y[i], 1e-6);
+}
+
+TEST(TCGSolver, reports_no_convergence_within_iteration_limit)
+{
+  const size_t n = 50;
+  const TSparseMatrix<double> a = make_laplace(n, 0.0);
+  TDynamicVector<double> x(n);
+  TCGSolver<double> cg(n);
+  TIterControl ctl;
+  ctl.max_iter = 2;
+  const TIterResult res = cg.solve(a, make_rhs(n), x, TIdentityPreconditioner(), ctl);
+
+  EXPECT_FALSE(res.converged);
+  EXPECT_EQ(size_t(2), res.iterations);
+}
+
+TEST(TCGSolver, zero_rhs_gives_zero_solution)
+{
+  TDynamicMatrix<double> a(3);
+  for (size_t i = 0; i < 3; i++)
+    a[i][i] = 1.0;
+  TDynamicVector<double> x(3);
+  x[1] = 5.0;
+  TCGSolver<double> cg(3);
+
+  EXPECT_TRUE(cg.solve(a, TDynamicVector<double>(3), x).converged);
+  EXPECT_EQ(TDynamicVector<double>(3), x);
+}
+
+TEST(TCGSolver, throws_when_sizes_differ)
+{
+  TCGSolver<double> cg(3);
+  TDynamicVector<double> x(3);
+
+  ASSERT_ANY_THROW(cg.solve(TDynamicMatrix<double>(4), TDynamicVector<double>(3), x));
+}
+
+TEST(TBiCGStabSolver, solves_nonsymmetric_sparse_system)
+{
+  const size_t n = 150;
+  vector<size_t> ri, ci;
+  vector<double> v;
+  for (size_t i = 0; i < n; i++)
+  {
+    ri.push_back(i); ci.push_back(i); v.push_back(4.0);
+    if (i > 0)
+    {
+      ri.push_back(i); ci.push_back(i - 1); v.push_back(-2.0);
+    }
+    if (i + 1 < n)
+    {
+      ri.push_back(i); ci.push_back(i + 1); v.push_back(-0.5);
+    }
+  }
+  const TSparseMatrix<double> a(n, n, ri, ci, v);
+  const TDynamicVector<double> b = make_rhs(n);
+  TDynamicVector<double> x(n);
+  TBiCGStabSolver<double> solver(n);
+  const TIterResult res = solver.solve(a, b, x, TJacobiPreconditioner<double>(a));
+
+  EXPECT_TRUE(res.converged);
+  EXPECT_LT(residual(to_dense(a), x, b), 1e-7);
+}
+
+TEST(TBiCGStabSolver, solves_dense_system)
+{
+  const size_t n = 30;
+  TDynamicMatrix<double> a(n);
+  for (size_t i = 0; i < n; i++)
+    for (size_t j = 0; j < n; j++)
+      a[i][j] = i == j ? double(n) : double((i * 3 + j * 7) % 5) - 2.0;
+  const TDynamicVector<double> b = make_rhs(n);
+  TDynamicVector<double> x(n);
+  TBiCGStabSolver<double> solver(n);
+
+  EXPECT_TRUE(solver.solve(a, b, x).converged);
+  EXPECT_LT(residual(a, x, b), 1e-7);
+}
+
+TEST(TJacobiPreconditioner, throws_on_zero_diagonal)
+{
+  ASSERT_ANY_THROW(TJacobiPreconditioner<double> m(TDynamicMatrix<double>(3)));
+}
+
+TEST(TCGSolver, iterations_do_not_allocate_memory)
+{
+  const size_t n = 60;
+  const TSparseMatrix<double> a = make_laplace(n, 0.1);
+  const TJacobiPreconditioner<double> m(a);
+  const TDynamicVector<double> b = make_rhs(n);
+  TDynamicVector<double> x(n);
+  TCGSolver<double> cg(n);
+  const size_t before = heap_allocations();
+  const TIterResult res = cg.solve(a, b, x, m);
+
+  EXPECT_TRUE(res.converged);
+  EXPECT_EQ(before, heap_allocations());
+}
+
+TEST(TCGSolver, dense_solve_does_not_allocate_memory)
+{
+  const size_t n = 40;
+  const TDynamicMatrix<double> a = to_dense(make_laplace(n, 0.1));
+  const TJacobiPreconditioner<double> m(a);
+  const TDynamicVector<double> b = make_rhs(n);
+  TDynamicVector<double> x(n);
+  TCGSolver<double> cg(n);
+  const size_t before = heap_allocations();
+  const TIterResult res = cg.solve(a, b, x, m);
+
+  EXPECT_TRUE(res.converged);
+  EXPECT_EQ(before, heap_allocations());
+}
+
+TEST(TBiCGStabSolver, dense_solve_does_not_allocate_memory)
+{
+  const size_t n = 40;
+  const TDynamicMatrix<double> a = to_dense(make_laplace(n, 0.3));
+  const TJacobiPreconditioner<double> m(a);
+  const TDynamicVector<double> b = make_rhs(n);
+  TDynamicVector<double> x(n);
+  TBiCGStabSolver<double> solver(n);
+  const size_t before = heap_allocations();
+  const TIterResult res = solver.solve(a, b, x, m);
+
+  EXPECT_TRUE(res.converged);
+  EXPECT_EQ(before, heap_allocations());
+}
@@ -0,0 +1,39 @@
+#include "tsparse.h"
+
+#include <gtest.h>
+
+TEST(TSparseMatrix, can_create_sparse_matrix)
+{
+  ASSERT_NO_THROW(TSparseMatrix<double> m(3, 4));
+}
+
+TEST(TSparseMatrix, throws_when_create_empty_matrix)
+{
+  ASSERT_ANY_THROW(TSparseMatrix<double> m(0, 4));
+}
+
+TEST(TSparseMatrix, duplicate_triplets_are_summed)
+{
+  TSparseMatrix<int> m(2, 2, { 1, 0, 1 }, { 0, 1, 0 }, { 1, 2, 3 });
+
+  EXPECT_EQ(2, m.nnz());
+  EXPECT_EQ(4, m(1, 0));
+  EXPECT_EQ(2, m(0, 1));
+  EXPECT_EQ(0, m(0, 0));
+}
+
+TEST(TSparseMatrix, throws_when_triplet_index_is_out_of_range)
+{
+  ASSERT_ANY_THROW(TSparseMatrix<int> m(2, 2, { 2 }, { 0 }, { 1 }));
+}
+
+TEST(TSparseMatrix, can_multiply_sparse_matrix_by_vector)
+{
+  TSparseMatrix<int> m(2, 3, { 0, 0, 1 }, { 0, 2, 1 }, { 1, 2, 3 });
+  TDynamicVector<int> v(3);
+  v[0] = 1; v[1] = 2; v[2] = 3;
+  TDynamicVector<int> r = m * v;
+
+  EXPECT_EQ(7, r[0]);
+  EXPECT_EQ(6, r[1]);
+}
@@ -0,0 +1,72 @@
+#include "tstrassen.h"
+
+#include <gtest.h>
+
+namespace
+{
+  TDynamicMatrix<long long> make_matrix(size_t n, int seed)
+  {
+    TDynamicMatrix<long long> m(n);
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < n; j++)
+        m[i][j] = (long long)((i * 7 + j * 3 + size_t(seed)) % 19) - 9;
+    return m;
+  }
+}
+
+TEST(TStrassen, matches_ordinary_product_for_power_of_two)
+{
+  const TDynamicMatrix<long long> a = make_matrix(32, 1), b = make_matrix(32, 2);
+
+  EXPECT_EQ(a * b, TStrassen<long long>(4).multiply(a, b));
+}
+
+TEST(TStrassen, matches_ordinary_product_for_odd_size)
+{
+  const TDynamicMatrix<long long> a = make_matrix(37, 3), b = make_matrix(37, 4);
+
+  EXPECT_EQ(a * b, TStrassen<long long>(5).multiply(a, b));
+}
+
+TEST(TStrassen, small_matrix_is_multiplied_directly)
+{
+  const TDynamicMatrix<long long> a = make_matrix(10, 5), b = make_matrix(10, 6);
+
+  EXPECT_EQ(a * b, strassen(a, b));
+}
+
+TEST(TStrassen, workspace_is_reused_between_calls)
+{
+  TStrassen<long long> s(8);
+  const TDynamicMatrix<long long> a = make_matrix(40, 7), b = make_matrix(40, 8), c = make_matrix(24, 9);
+  TDynamicMatrix<long long> r(40);
+  s.multiply(a, b, r);
+  EXPECT_EQ(a * b, r);
+  EXPECT_EQ(c * c, s.multiply(c, c)); // меньший размер - в той же памяти
+  s.multiply(b, a, r);
+  EXPECT_EQ(b * a, r);
+}
+
+TEST(TStrassen, double_product_is_close_to_ordinary)
+{
+  TDynamicMatrix<double> a(48), b(48);
+  for (size_t i = 0; i < 48; i++)
+    for (size_t j = 0; j < 48; j++)
+    {
+      a[i][j] = 1.0 / double(1 + i + j);
+      b[i][j] = double((i + j) % 5) / 3.0;
+    }
+  const TDynamicMatrix<double> c = a * b, s = TStrassen<double>(6).multiply(a, b);
+
+  for (size_t i = 0; i < 48; i++)
+    for (size_t j = 0; j < 48; j++)
+      EXPECT_NEAR(c[i][j], s[i][j], 1e-12);
+}
+
+TEST(TStrassen, throws_when_sizes_differ)
+{
+  TStrassen<int> s;
+  TDynamicMatrix<int> a(3), b(4), c(3);
+
+  ASSERT_ANY_THROW(s.multiply(a, b, c));
+}
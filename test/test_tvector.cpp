@@ -1,6 +1,8 @@
 #include "tmatrix.h"
 
 #include <gtest.h>
+#include <iomanip>
+#include <sstream>
 
 TEST(TDynamicVector, can_create_vector_with_positive_length)
 {
@@ -26,12 +28,21 @@ TEST(TDynamicVector, can_create_copied_vector)
 
 TEST(TDynamicVector, copied_vector_is_equal_to_source_one)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(3);
+  v[0] = 1; v[1] = 2; v[2] = 3;
+  TDynamicVector<int> v1(v);
+
+  EXPECT_EQ(v, v1);
 }
 
 TEST(TDynamicVector, copied_vector_has_its_own_memory)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(3);
+  TDynamicVector<int> v1(v);
+  v1[0] = 5;
+
+  EXPECT_EQ(0, v[0]);
+  EXPECT_NE(&v[0], &v1[0]);
 }
 
 TEST(TDynamicVector, can_get_size)
@@ -41,101 +52,290 @@ TEST(TDynamicVector, can_get_size)
   EXPECT_EQ(4, v.size());
 }
 
-//TEST(TDynamicVector, can_set_and_get_element)
-//{
-//  TDynamicVector<int> v(4);
-//  v[0] = 4;
-//
-//  EXPECT_EQ(4, v[0]);
-//}
+TEST(TDynamicVector, can_set_and_get_element)
+{
+  TDynamicVector<int> v(4);
+  v[0] = 4;
+
+  EXPECT_EQ(4, v[0]);
+}
 
 TEST(TDynamicVector, throws_when_set_element_with_negative_index)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(4);
+
+  ASSERT_ANY_THROW(v.at(-1) = 1);
 }
 
 TEST(TDynamicVector, throws_when_set_element_with_too_large_index)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(4);
+
+  ASSERT_ANY_THROW(v.at(4) = 1);
 }
 
 TEST(TDynamicVector, can_assign_vector_to_itself)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(3);
+  v[1] = 7;
+  TDynamicVector<int>& r = v;
+
+  ASSERT_NO_THROW(v = r);
+  EXPECT_EQ(7, v[1]);
 }
 
 TEST(TDynamicVector, can_assign_vectors_of_equal_size)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(3), v1(3);
+  v[2] = 9;
+  v1 = v;
+
+  EXPECT_EQ(v, v1);
 }
 
 TEST(TDynamicVector, assign_operator_change_vector_size)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(3), v1(5);
+  v1 = v;
+
+  EXPECT_EQ(3, v1.size());
 }
 
 TEST(TDynamicVector, can_assign_vectors_of_different_size)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(3), v1(5);
+  v[0] = 2;
+  v1 = v;
+
+  EXPECT_EQ(v, v1);
 }
 
 TEST(TDynamicVector, compare_equal_vectors_return_true)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(3), v1(3);
+  v[0] = v1[0] = 4;
+
+  EXPECT_TRUE(v == v1);
 }
 
 TEST(TDynamicVector, compare_vector_with_itself_return_true)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(3);
+
+  EXPECT_TRUE(v == v);
 }
 
 TEST(TDynamicVector, vectors_with_different_size_are_not_equal)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(3), v1(4);
+
+  EXPECT_TRUE(v != v1);
 }
 
 TEST(TDynamicVector, can_add_scalar_to_vector)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(2);
+  v[0] = 1; v[1] = 2;
+  TDynamicVector<int> r = v + 3;
+
+  EXPECT_EQ(4, r[0]);
+  EXPECT_EQ(5, r[1]);
 }
 
 TEST(TDynamicVector, can_subtract_scalar_from_vector)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(2);
+  v[0] = 1; v[1] = 2;
+  TDynamicVector<int> r = v - 3;
+
+  EXPECT_EQ(-2, r[0]);
+  EXPECT_EQ(-1, r[1]);
 }
 
 TEST(TDynamicVector, can_multiply_scalar_by_vector)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(2);
+  v[0] = 1; v[1] = 2;
+  TDynamicVector<int> r = v * 3;
+
+  EXPECT_EQ(3, r[0]);
+  EXPECT_EQ(6, r[1]);
 }
 
 TEST(TDynamicVector, can_add_vectors_with_equal_size)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(2), v1(2);
+  v[0] = 1; v[1] = 2;
+  v1[0] = 10; v1[1] = 20;
+  TDynamicVector<int> r = v + v1;
+
+  EXPECT_EQ(11, r[0]);
+  EXPECT_EQ(22, r[1]);
 }
 
 TEST(TDynamicVector, cant_add_vectors_with_not_equal_size)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(2), v1(3);
+
+  ASSERT_ANY_THROW(v + v1);
 }
 
 TEST(TDynamicVector, can_subtract_vectors_with_equal_size)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(2), v1(2);
+  v[0] = 1; v[1] = 2;
+  v1[0] = 10; v1[1] = 20;
+  TDynamicVector<int> r = v1 - v;
+
+  EXPECT_EQ(9, r[0]);
+  EXPECT_EQ(18, r[1]);
 }
 
 TEST(TDynamicVector, cant_subtract_vectors_with_not_equal_size)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(2), v1(3);
+
+  ASSERT_ANY_THROW(v - v1);
 }
 
 TEST(TDynamicVector, can_multiply_vectors_with_equal_size)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(2), v1(2);
+  v[0] = 1; v[1] = 2;
+  v1[0] = 3; v1[1] = 4;
+
+  EXPECT_EQ(11, v * v1);
 }
 
 TEST(TDynamicVector, cant_multiply_vectors_with_not_equal_size)
 {
-  ADD_FAILURE();
+  TDynamicVector<int> v(2), v1(3);
+
+  ASSERT_ANY_THROW(v * v1);
+}
+
+TEST(TDynamicVector, can_read_integer_vector)
+{
+  TDynamicVector<int> v(4);
+  istringstream in(" 1\t-2\n+3  40 5");
+  in >> v;
+
+  EXPECT_TRUE(in.good());
+  EXPECT_EQ(1, v[0]);
+  EXPECT_EQ(-2, v[1]);
+  EXPECT_EQ(3, v[2]);
+  EXPECT_EQ(40, v[3]);
+  int rest;
+  in >> rest;
+  EXPECT_EQ(5, rest);
+}
+
+TEST(TDynamicVector, can_read_double_vector)
+{
+  TDynamicVector<double> v(3);
+  istringstream in("1.5 -2e3 0.1");
+  in >> v;
+
+  EXPECT_FALSE(in.fail());
+  EXPECT_TRUE(in.eof());
+  EXPECT_EQ(1.5, v[0]);
+  EXPECT_EQ(-2000.0, v[1]);
+  EXPECT_EQ(0.1, v[2]);
+}
+
+TEST(TDynamicVector, unsigned_read_wraps_negative_values_like_iostream)
+{
+  TDynamicVector<unsigned> v(3);
+  istringstream in("-1 -7 -0"), expected_in("-1 -7 -0");
+  in >> v;
+  unsigned expected[3];
+  expected_in >> expected[0] >> expected[1] >> expected[2];
+
+  ASSERT_FALSE(expected_in.fail());
+  EXPECT_FALSE(in.fail());
+  for (size_t i = 0; i < 3; i++)
+    EXPECT_EQ(expected[i], v[i]);
+  EXPECT_EQ(numeric_limits<unsigned>::max(), v[0]);
+}
+
+TEST(TDynamicVector, read_sets_failbit_on_bad_input)
+{
+  TDynamicVector<int> v(3);
+  istringstream in("1 x 3");
+  in >> v;
+
+  EXPECT_TRUE(in.fail());
+}
+
+TEST(TDynamicVector, read_sets_failbit_on_short_input)
+{
+  TDynamicVector<double> v(3);
+  istringstream in("1 2");
+  in >> v;
+
+  EXPECT_TRUE(in.fail());
+  EXPECT_TRUE(in.eof());
 }
 
+TEST(TDynamicVector, read_sets_failbit_on_too_long_token)
+{
+  TDynamicVector<int> v(2);
+  istringstream in(string(200, '0') + "1 2");
+  in >> v;
+
+  EXPECT_TRUE(in.fail());
+}
+
+TEST(TDynamicVector, can_read_token_of_buffer_length)
+{
+  TDynamicVector<int> v(2);
+  istringstream in(string(127, '0') + "7 " + string(127, '0') + "8");
+  in >> v;
+
+  EXPECT_FALSE(in.fail());
+  EXPECT_EQ(7, v[0]);
+  EXPECT_EQ(8, v[1]);
+}
+
+TEST(TDynamicVector, read_respects_stream_format_flags)
+{
+  TDynamicVector<int> v(2);
+  istringstream in("ff 10");
+  in >> hex >> v;
+
+  EXPECT_EQ(255, v[0]);
+  EXPECT_EQ(16, v[1]);
+}
+
+TEST(TDynamicVector, can_write_vector)
+{
+  TDynamicVector<int> v(3);
+  v[0] = 1; v[1] = -20; v[2] = 300;
+  ostringstream out;
+  out << v;
+
+  EXPECT_EQ("1 -20 300 ", out.str());
+}
+
+TEST(TDynamicVector, write_respects_stream_precision)
+{
+  TDynamicVector<double> v(2);
+  v[0] = 1.0 / 3; v[1] = 2.5;
+  ostringstream out, expected;
+  out << setprecision(3) << v;
+  expected << setprecision(3) << v[0] << ' ' << v[1] << ' ';
+
+  EXPECT_EQ(expected.str(), out.str());
+  EXPECT_EQ("0.333 2.5 ", out.str());
+}
+
+TEST(TDynamicVector, written_doubles_read_back_exactly)
+{
+  TDynamicVector<double> v(3), v1(3);
+  v[0] = 0.1; v[1] = -1.0 / 3; v[2] = 1e300;
+  stringstream io;
+  io << v;
+  io >> v1;
+
+  EXPECT_EQ(v, v1);
+}